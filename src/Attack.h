@@ -234,4 +234,96 @@ inline bool in_check(const Position& pos, Color sideToCheck) {
     return is_square_attacked(pos, ksq, flip(sideToCheck));
 }
 
+// -------------------------------------
+// Check detection for moves about to be played
+// -------------------------------------
+
+// Per-node data for the side to move: squares from which each piece type would
+// attack the enemy king, and own pieces that shield an own slider from it.
+struct CheckInfo {
+    int ksq = -1;
+    Bitboard checkSq[7]{};
+    Bitboard discoverers = 0ULL;
+};
+
+inline CheckInfo check_info(const Position& pos) {
+    CheckInfo ci;
+    const Color us = pos.side;
+    const Color them = flip(us);
+    ci.ksq = pos.king_square(them);
+    if (ci.ksq < 0)
+        return ci;
+
+    ci.checkSq[PAWN] = T().pawn[them][ci.ksq];
+    ci.checkSq[KNIGHT] = T().knight[ci.ksq];
+
+    const int kf = file_of(ci.ksq);
+    const int kr = rank_of(ci.ksq);
+    auto scan = [&](int df, int dr, bool diag) {
+        Bitboard& ray = ci.checkSq[diag ? BISHOP : ROOK];
+        int ff = kf + df;
+        int rr = kr + dr;
+        int blocker = -1;
+        while ((unsigned)ff < 8u && (unsigned)rr < 8u) {
+            const int sq = make_sq(ff, rr);
+            const Piece p = pos.board[sq];
+            if (blocker < 0)
+                ray |= bb_sq(sq);
+            if (p != NO_PIECE) {
+                if (blocker >= 0) {
+                    const bool slider = diag ? is_slider_bishop_queen(p, us) : is_slider_rook_queen(p, us);
+                    if (slider)
+                        ci.discoverers |= bb_sq(blocker);
+                    break;
+                }
+                if (color_of(p) != us)
+                    break;
+                blocker = sq;
+            }
+            ff += df;
+            rr += dr;
+        }
+    };
+
+    scan(+1, +1, true);
+    scan(-1, +1, true);
+    scan(+1, -1, true);
+    scan(-1, -1, true);
+    scan(+1, 0, false);
+    scan(-1, 0, false);
+    scan(0, +1, false);
+    scan(0, -1, false);
+
+    ci.checkSq[QUEEN] = ci.checkSq[BISHOP] | ci.checkSq[ROOK];
+    return ci;
+}
+
+// True if pseudo-legal move m by the side to move gives check. Castling, en passant
+// and promotions are rare and change several squares, so they are verified by making the move.
+inline bool gives_check(Position& pos, const CheckInfo& ci, Move m) {
+    if (ci.ksq < 0)
+        return false;
+
+    if (flags_of(m) & (MF_CASTLE | MF_EP | MF_PROMO)) {
+        const Color us = pos.side;
+        Undo u = pos.do_move(m);
+        const bool chk = in_check(pos, flip(us));
+        pos.undo_move(m, u);
+        return chk;
+    }
+
+    const int from = from_sq(m);
+    const int to = to_sq(m);
+    if (ci.checkSq[type_of(pos.board[from])] & bb_sq(to))
+        return true;
+
+    if (ci.discoverers & bb_sq(from)) {
+        // Still shielding if the piece stays on the line through the king.
+        const int f1 = file_of(from) - file_of(ci.ksq), r1 = rank_of(from) - rank_of(ci.ksq);
+        const int f2 = file_of(to) - file_of(ci.ksq), r2 = rank_of(to) - rank_of(ci.ksq);
+        return f1 * r2 != f2 * r1;
+    }
+    return false;
+}
+
 } // namespace attacks
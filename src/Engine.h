@@ -6,6 +6,8 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <iostream>
 #include <filesystem>
 
 #include "types.h"
@@ -17,7 +19,7 @@
 class Engine {
   public:
     Engine() {
-        pos.set_startpos();
+        set_startpos();
         init_default_book_file();
     }
 
@@ -25,7 +27,7 @@ class Engine {
 
     void new_game() {
         stop();
-        pos.set_startpos();
+        set_startpos();
         search::clear_tt();
         last_ponder_move_.store(0, std::memory_order_relaxed);
     }
@@ -47,6 +49,8 @@ class Engine {
     void set_skill_level(int lv) { skill_level_ = std::max(0, std::min(20, lv)); }
     int skill_level() const { return skill_level_; }
     void set_search_stats(bool on) { search::set_collect_stats(on); }
+    void set_smp_mode(search::SmpMode m) { search::set_smp_mode(m); }
+    void set_thread_affinity(bool on) { search::set_thread_affinity(on); }
     void set_use_book(bool on) { use_book_ = on; }
     void set_book_depth(int ply) { book_max_ply_ = std::max(0, std::min(128, ply)); }
     void set_book_file(const std::string& path) {
@@ -55,28 +59,34 @@ class Engine {
     }
 
     // Position management.
-    void set_startpos() { pos.set_startpos(); }
-    void set_fen(const std::string& fen) { pos.set_fen(fen); }
+    void set_startpos() {
+        pos.set_startpos();
+        reset_history();
+    }
+    void set_fen(const std::string& fen) {
+        pos.set_fen(fen);
+        reset_history();
+    }
     Color side_to_move() const { return pos.side; }
 
     // Stop any ongoing search and join background thread.
     void stop() {
         search::stop();
+        end_pondering();
 
-        if (searching_.load(std::memory_order_acquire)) {
-            std::lock_guard<std::mutex> g(bg_mtx_);
-            if (bg_thread_.joinable())
-                bg_thread_.join();
-            searching_.store(false, std::memory_order_release);
-            pondering_.store(false, std::memory_order_release);
-        }
+        std::lock_guard<std::mutex> g(bg_mtx_);
+        if (bg_thread_.joinable())
+            bg_thread_.join();
+        searching_.store(false, std::memory_order_release);
     }
 
-    // UCI: ponderhit. Stop background ponder search and keep its last result.
+    // UCI: ponderhit. The running ponder search switches to the clock sent with
+    // `go ponder`, counted from now; its thread prints bestmove when it ends.
     void ponderhit() {
         if (!pondering_.load(std::memory_order_acquire))
             return;
-        stop();
+        search::ponderhit(ponder_limits_);
+        end_pondering();
     }
 
     // Apply a UCI move string if it matches a legal move.
@@ -89,6 +99,7 @@ class Engine {
             if (move_to_uci(m) == uciMove) {
                 Undo u = pos.do_move(m);
                 (void)u;
+                history_.push_back(pos.zobKey);
                 return;
             }
         }
@@ -115,89 +126,51 @@ class Engine {
             }
         }
 
-        search::Limits lim{};
-        lim.depth = 0;
-        lim.movetime_ms = 0;
-        lim.infinite = false;
-
         const bool depth_given = (depth > 0);
-        const bool movetime_given = (movetime > 0);
-
-        const bool hasClock = (wtime > 0) || (btime > 0) || (winc > 0) || (binc > 0) || (movestogo > 0);
 
-        // Ponder: run an infinite search in the background and return no bestmove yet.
+        // Ponder: search without deadlines in the background and keep the timed limits
+        // for ponderhit. No bestmove is returned here.
         if (ponder) {
+            ponder_limits_ = timed_limits(depth, movetime, wtime, btime, winc, binc, movestogo);
+
+            search::Limits lim{};
             lim.infinite = true;
             lim.movetime_ms = 0;
             lim.depth = depth_given ? depth : 0;
+            lim.ponder = true;
 
-            start_background_search(lim);
+            // Arm the untimed clock here, not on the search thread: an early ponderhit
+            // must find it armed, or the search thread would undo its deadlines.
+            search::wait_tt_clear();
+            search::start_timer(0, true);
             pondering_.store(true, std::memory_order_release);
-            return 0; // UCI: do not output bestmove on ponder start.
+            start_background_search(lim);
+            return 0;
         }
 
-        // 1) infinite
+        search::Limits lim{};
         if (infinite) {
             lim.infinite = true;
             lim.movetime_ms = 0;
             lim.depth = depth_given ? depth : 0;
-
-            search::Result r = search::think(pos, lim);
-            last_ponder_move_.store((int)r.ponderMove, std::memory_order_relaxed);
-            return (int)r.bestMove;
-        }
-
-        // 2) movetime takes absolute precedence (after ponder/infinite).
-        if (movetime_given) {
-            lim.infinite = false;
-            lim.movetime_ms = std::max(1, movetime);
-            lim.depth = depth_given ? depth : 0;
-
-            search::Result r = search::think(pos, lim);
-            last_ponder_move_.store((int)r.ponderMove, std::memory_order_relaxed);
-            return (int)r.bestMove;
-        }
-
-        // 3) Clock mode: use wtime/btime and increments if provided.
-        if (hasClock) {
-            int myTime = (pos.side == WHITE ? wtime : btime);
-            int myInc = (pos.side == WHITE ? winc : binc);
-
-            if (myTime < 0)
-                myTime = 0;
-            if (myInc < 0)
-                myInc = 0;
-
-            int t_ms = compute_think_ms(myTime, myInc, movestogo, move_overhead_ms_);
-            if (t_ms < 1)
-                t_ms = 1;
-
-            lim.movetime_ms = t_ms;
-            lim.infinite = false;
         } else {
-            // 4) Depth-only search (no clock, no movetime).
-            lim.movetime_ms = 0;
-            lim.infinite = false;
+            lim = timed_limits(depth, movetime, wtime, btime, winc, binc, movestogo);
         }
 
-        // Depth strategy.
-        lim.depth = depth_given ? depth : 0;
-
-        // Skill Level: cap depth and time only in clock mode without a forced depth.
-        if (!depth_given && hasClock && skill_level_ < 20) {
-            int capDepth = 4 + skill_level_ / 2; // 0..19 -> 4..13
-            capDepth = std::max(1, std::min(64, capDepth));
-            lim.depth = capDepth;
-
-            int factor = 40 + (skill_level_ * 50) / 19; // 40..90
-            lim.movetime_ms = std::max(1, (lim.movetime_ms * factor) / 100);
-        }
-
-        search::Result r = search::think(pos, lim);
+        search::Result r = search::think(pos, lim, history_);
         last_ponder_move_.store((int)r.ponderMove, std::memory_order_relaxed);
         return (int)r.bestMove;
     }
 
+    // UCI bestmove line for a finished search.
+    void print_bestmove(int bestMove, int ponderMove) const {
+        std::cout << "bestmove " << move_to_uci(bestMove);
+        if (ponderMove)
+            std::cout << " ponder " << move_to_uci(ponderMove);
+        std::cout << "\n";
+        std::cout.flush();
+    }
+
     // Convert an encoded move to UCI coordinate notation.
     std::string move_to_uci(int m) const { return move_to_uci((Move)m); }
 
@@ -244,57 +217,93 @@ class Engine {
     }
 
   private:
-    // Time allocation for clock mode only (ms).
-    static inline int compute_think_ms(int mytime_ms, int myinc_ms, int movestogo, int move_overhead_ms) {
-        if (mytime_ms <= 0)
-            return 1;
-
-        int tleft = mytime_ms - std::max(0, move_overhead_ms);
-        if (tleft < 1)
-            tleft = 1;
-
-        if (tleft <= 200) {
-            return std::max(1, tleft / 4);
-        }
-
-        int inc_part = (myinc_ms * 85) / 100;
-
-        int t = 0;
-        if (movestogo > 0) {
-            int mtg = std::max(1, movestogo);
-            int base = tleft / mtg;
-            t = base + inc_part;
-            t = std::min(t, (tleft * 60) / 100);
-        } else {
-            int base = tleft / 30;
-            t = base + inc_part;
-            t = std::min(t, tleft / 2);
-        }
-
-        t = std::max(t, 5);
-        if (t > 2)
-            t -= 2;
-        return t;
-    }
-
     void start_background_search(const search::Limits& lim) {
         // Work on a copy of the current position to avoid mutating engine state.
         Position pcopy = pos;
+        std::vector<uint64_t> hcopy = history_;
 
         searching_.store(true, std::memory_order_release);
 
         std::lock_guard<std::mutex> g(bg_mtx_);
-        bg_thread_ = std::thread([this, pcopy, lim]() mutable {
-            // Background search does not emit info to avoid interleaving.
-            search::Result r = search::think(pcopy, lim);
+        bg_thread_ = std::thread([this, pcopy, hcopy, lim]() mutable {
+            search::Result r = search::think(pcopy, lim, hcopy);
             last_best_move_.store((int)r.bestMove, std::memory_order_relaxed);
             last_ponder_move_.store((int)r.ponderMove, std::memory_order_relaxed);
+
+            // UCI forbids bestmove while pondering, even if the search ran out of depth early.
+            {
+                std::unique_lock<std::mutex> lk(ponder_mtx_);
+                ponder_cv_.wait(lk, [this]() { return !pondering_.load(std::memory_order_acquire); });
+            }
+            print_bestmove((int)r.bestMove, (int)r.ponderMove);
             searching_.store(false, std::memory_order_release);
         });
     }
 
+    void end_pondering() {
+        {
+            std::lock_guard<std::mutex> g(ponder_mtx_);
+            pondering_.store(false, std::memory_order_release);
+        }
+        ponder_cv_.notify_all();
+    }
+
+    // Limits for a timed search: movetime, else the clock, else depth only.
+    search::Limits timed_limits(int depth, int movetime, int wtime, int btime, int winc, int binc,
+                                int movestogo) const {
+        search::Limits lim{};
+        lim.depth = 0;
+        lim.movetime_ms = 0;
+        lim.infinite = false;
+
+        const bool depth_given = (depth > 0);
+        const bool hasClock = (wtime > 0) || (btime > 0) || (winc > 0) || (binc > 0) || (movestogo > 0);
+
+        // Movetime takes absolute precedence over the clock.
+        if (movetime > 0) {
+            lim.movetime_ms = std::max(1, movetime);
+            lim.depth = depth_given ? depth : 0;
+            return lim;
+        }
+
+        if (hasClock) {
+            int myTime = (pos.side == WHITE ? wtime : btime);
+            int myInc = (pos.side == WHITE ? winc : binc);
+
+            if (myTime < 0)
+                myTime = 0;
+            if (myInc < 0)
+                myInc = 0;
+
+            const search::TimeBudget tb = search::compute_time_budget(myTime, myInc, movestogo, move_overhead_ms_);
+            lim.movetime_ms = tb.maximum_ms;
+            lim.optimum_ms = tb.optimum_ms;
+        }
+
+        lim.depth = depth_given ? depth : 0;
+
+        // Skill Level: cap depth and time only in clock mode without a forced depth.
+        if (!depth_given && hasClock && skill_level_ < 20) {
+            int capDepth = 4 + skill_level_ / 2; // 0..19 -> 4..13
+            capDepth = std::max(1, std::min(64, capDepth));
+            lim.depth = capDepth;
+
+            int factor = 40 + (skill_level_ * 50) / 19; // 40..90
+            lim.movetime_ms = std::max(1, (lim.movetime_ms * factor) / 100);
+            lim.optimum_ms = std::max(1, (lim.optimum_ms * factor) / 100);
+        }
+        return lim;
+    }
+
+    // Game history keys since the last position command; the last entry is the current position.
+    void reset_history() {
+        history_.clear();
+        history_.push_back(pos.zobKey);
+    }
+
   private:
     Position pos;
+    std::vector<uint64_t> history_;
 
     // options cache
     int threads_ = 1;
@@ -313,6 +322,10 @@ class Engine {
     std::atomic<int> last_best_move_{0};
     std::atomic<int> last_ponder_move_{0};
 
+    search::Limits ponder_limits_{}; // timed limits applied on ponderhit
+    std::mutex ponder_mtx_;
+    std::condition_variable ponder_cv_;
+
     std::thread bg_thread_;
     std::mutex bg_mtx_;
 };
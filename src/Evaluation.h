@@ -6,6 +6,7 @@
 
 #include "types.h"
 #include "Position.h"
+#include "PieceSquare.h"
 
 namespace eval {
 
@@ -53,72 +54,12 @@ static inline int mirror_sq(int sq) {
     return sq ^ 56;
 }
 
-// =====================================================
-// Material values (MG/EG)
-// =====================================================
-static constexpr int MG_VAL[7] = {0, 100, 320, 330, 500, 900, 0};
-static constexpr int EG_VAL[7] = {0, 120, 300, 320, 520, 900, 0};
-
 inline int mg_value(PieceType pt) {
     if (pt < PAWN || pt > KING)
         return 0;
     return MG_VAL[(int)pt];
 }
 
-// =====================================================
-// PSQT (MG/EG)
-// =====================================================
-static constexpr int PST_P_MG[64] = {0,  0,  0,   0,  0,  0,   0,  0,  5,  10, 10, -20, -20, 10, 10, 5,
-                                     5,  -5, -10, 0,  0,  -10, -5, 5,  0,  0,  0,  20,  20,  0,  0,  0,
-                                     5,  5,  10,  25, 25, 10,  5,  5,  10, 10, 20, 30,  30,  20, 10, 10,
-                                     50, 50, 50,  50, 50, 50,  50, 50, 0,  0,  0,  0,   0,   0,  0,  0};
-static constexpr int PST_P_EG[64] = {0, 0, 0, 0, 0,  0,  0,  0,  10, 10, 10, 10, 10, 10, 10, 10, 8, 8, 8, 12, 12, 8,
-                                     8, 8, 6, 6, 10, 14, 14, 10, 6,  6,  4,  4,  6,  10, 10, 6,  4, 4, 2, 2,  2,  6,
-                                     6, 2, 2, 2, 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 0, 0, 0};
-
-static constexpr int PST_N_MG[64] = {-50, -40, -30, -30, -30, -30, -40, -50, -40, -20, 0,   5,   5,   0,   -20, -40,
-                                     -30, 5,   10,  15,  15,  10,  5,   -30, -30, 0,   15,  20,  20,  15,  0,   -30,
-                                     -30, 5,   15,  20,  20,  15,  5,   -30, -30, 0,   10,  15,  15,  10,  0,   -30,
-                                     -40, -20, 0,   0,   0,   0,   -20, -40, -50, -40, -30, -30, -30, -30, -40, -50};
-static constexpr int PST_N_EG[64] = {-40, -25, -20, -15, -15, -20, -25, -40, -25, -10, 0,   5,   5,   0,   -10, -25,
-                                     -20, 5,   10,  15,  15,  10,  5,   -20, -15, 5,   15,  20,  20,  15,  5,   -15,
-                                     -15, 5,   15,  20,  20,  15,  5,   -15, -20, 5,   10,  15,  15,  10,  5,   -20,
-                                     -25, -10, 0,   5,   5,   0,   -10, -25, -40, -25, -20, -15, -15, -20, -25, -40};
-
-static constexpr int PST_B_MG[64] = {-20, -10, -10, -10, -10, -10, -10, -20, -10, 5,   0,   0,   0,   0,   5,   -10,
-                                     -10, 10,  10,  10,  10,  10,  10,  -10, -10, 0,   10,  10,  10,  10,  0,   -10,
-                                     -10, 5,   5,   10,  10,  5,   5,   -10, -10, 0,   5,   10,  10,  5,   0,   -10,
-                                     -10, 0,   0,   0,   0,   0,   0,   -10, -20, -10, -10, -10, -10, -10, -10, -20};
-static constexpr int PST_B_EG[64] = {-10, -5, -5, -5, -5, -5, -5, -10, -5,  5,  0,  0,  0,  0,  5,  -5,
-                                     -5,  8,  10, 10, 10, 10, 8,  -5,  -5,  0,  10, 12, 12, 10, 0,  -5,
-                                     -5,  0,  10, 12, 12, 10, 0,  -5,  -5,  8,  10, 10, 10, 10, 8,  -5,
-                                     -5,  5,  0,  0,  0,  0,  5,  -5,  -10, -5, -5, -5, -5, -5, -5, -10};
-
-static constexpr int PST_R_MG[64] = {0, 0,  5,  10, 10, 5,  0,  0,  -5, 0,  0,  0, 0, 0, 0, -5, -5, 0,  0,  0, 0, 0,
-                                     0, -5, -5, 0,  0,  0,  0,  0,  0,  -5, -5, 0, 0, 0, 0, 0,  0,  -5, -5, 0, 0, 0,
-                                     0, 0,  0,  -5, 5,  10, 10, 10, 10, 10, 10, 5, 0, 0, 0, 2,  2,  0,  0,  0};
-static constexpr int PST_R_EG[64] = {0,  0, 5, 8, 8, 5,  0,  0, 0, 5, 8, 10, 10, 8,  5,  0, 0, 5, 8, 10, 10, 8,
-                                     5,  0, 0, 5, 8, 10, 10, 8, 5, 0, 0, 5,  8,  10, 10, 8, 5, 0, 0, 5,  8,  10,
-                                     10, 8, 5, 0, 0, 0,  5,  8, 8, 5, 0, 0,  0,  0,  0,  3, 3, 0, 0, 0};
-
-static constexpr int PST_Q_MG[64] = {-20, -10, -10, -5, -5, -10, -10, -20, -10, 0,   0,   0,  0,  0,   0,   -10,
-                                     -10, 0,   5,   5,  5,  5,   0,   -10, -5,  0,   5,   5,  5,  5,   0,   -5,
-                                     0,   0,   5,   5,  5,  5,   0,   -5,  -10, 5,   5,   5,  5,  5,   0,   -10,
-                                     -10, 0,   5,   0,  0,  0,   0,   -10, -20, -10, -10, -5, -5, -10, -10, -20};
-static constexpr int PST_Q_EG[64] = {-10, -5, -5, -2, -2, -5, -5, -10, -5,  0,  0,  0,  0,  0,  0,  -5,
-                                     -5,  0,  3,  3,  3,  3,  0,  -5,  -2,  0,  3,  4,  4,  3,  0,  -2,
-                                     -2,  0,  3,  4,  4,  3,  0,  -2,  -5,  0,  3,  3,  3,  3,  0,  -5,
-                                     -5,  0,  0,  0,  0,  0,  0,  -5,  -10, -5, -5, -2, -2, -5, -5, -10};
-
-static constexpr int PST_K_MG[64] = {-30, -40, -40, -50, -50, -40, -40, -30, -30, -40, -40, -50, -50, -40, -40, -30,
-                                     -30, -40, -40, -50, -50, -40, -40, -30, -30, -40, -40, -50, -50, -40, -40, -30,
-                                     -20, -30, -30, -40, -40, -30, -30, -20, -10, -20, -20, -20, -20, -20, -20, -10,
-                                     20,  20,  0,   0,   0,   0,   20,  20,  20,  30,  10,  0,   0,   10,  30,  20};
-static constexpr int PST_K_EG[64] = {-50, -30, -30, -30, -30, -30, -30, -50, -30, -10, 0,   0,   0,   0,   -10, -30,
-                                     -30, 0,   10,  15,  15,  10,  0,   -30, -30, 0,   15,  20,  20,  15,  0,   -30,
-                                     -30, 0,   15,  20,  20,  15,  0,   -30, -30, 0,   10,  15,  15,  10,  0,   -30,
-                                     -30, -10, 0,   0,   0,   0,   -10, -30, -50, -30, -30, -30, -30, -30, -30, -50};
-
 // =====================================================
 // Weights (base)
 // =====================================================
@@ -164,6 +105,14 @@ static constexpr int BAD_BISHOP_EG = 4;
 
 static constexpr int CENTER_CONTROL_MG = 2;
 
+// Material imbalance: knights gain and rooks lose value as own pawns come on (per pawn above 5).
+static constexpr int KNIGHT_PAWN_ADJ = 3;
+static constexpr int ROOK_PAWN_ADJ = 6;
+
+// Endgame scale factors, applied to the EG term of the side ahead (64 = unscaled).
+static constexpr int SCALE_NORMAL = 64;
+static constexpr int SCALE_NONE = -1; // a scaling function that does not apply
+
 // Side-to-move weights for tempo and king safety tuning.
 struct Weights {
     int tempoMG;
@@ -204,31 +153,13 @@ static inline Weights weights_for(Color stm) {
     }
 }
 
+static inline int piece_count(const Position& pos, Color c, PieceType pt) {
+    return pos.pieceCount[make_piece(c, pt)];
+}
+
 // Phase (0..256) for MG/EG interpolation.
 inline int game_phase_256(const Position& pos) {
-    int phase = 0;
-    for (int sq = 0; sq < 64; sq++) {
-        Piece p = pos.board[sq];
-        if (p == NO_PIECE)
-            continue;
-        switch (type_of(p)) {
-        case KNIGHT:
-            phase += 1;
-            break;
-        case BISHOP:
-            phase += 1;
-            break;
-        case ROOK:
-            phase += 2;
-            break;
-        case QUEEN:
-            phase += 4;
-            break;
-        default:
-            break;
-        }
-    }
-    phase = clampi(phase, 0, 24);
+    const int phase = clampi(pos.phaseWeight, 0, 24);
     return (phase * 256) / 24;
 }
 
@@ -420,9 +351,25 @@ static inline int low_bit(uint8_t m) {
     return -1;
 }
 
-// Pawn structure evaluation: isolated/doubled/connected, passers, and king shields.
-static inline Score eval_pawns(const Position& pos, const PawnInfo& pi, int kingSqW, int kingSqB, const Weights& W) {
-    Score s{0, 0};
+// Everything derived from the pawns alone, cached in the pawn hash under Position::pawnKey.
+// A default entry describes the pawnless structure, which is also what key 0 stands for.
+struct PawnEntry {
+    uint64_t key = 0;
+    Score score{0, 0};               // doubled/isolated/connected/backward pawns, passers, center
+    PawnInfo pi{};
+    uint64_t passed[2]{};            // passed pawns per color
+    uint8_t semiOpen[2]{0xFF, 0xFF}; // files without a pawn of that color
+    uint8_t pawnsOnColor[2][2]{};    // [color][dark square] pawn counts, for bad bishops
+};
+
+// Pawn-only structure evaluation: isolated/doubled/connected/backward pawns, passers and
+// central pawn control. Terms that also depend on pieces or kings live in eval_pawns.
+static inline void compute_pawn_entry(const Position& pos, PawnEntry& e) {
+    e = PawnEntry{};
+    e.key = pos.pawnKey;
+    e.pi = gather_pawns(pos);
+    const PawnInfo& pi = e.pi;
+    Score& s = e.score;
 
     auto eval_color = [&](Color c) {
         int ci = (c == WHITE) ? 0 : 1;
@@ -560,18 +507,12 @@ static inline Score eval_pawns(const Position& pos, const PawnInfo& pi, int king
                 }
 
                 if (passed) {
+                    e.passed[ci] |= 1ULL << make_sq(f, r);
                     int pr = (c == WHITE) ? r : (7 - r);
                     pr = clampi(pr, 0, 7);
                     s.mg += sign * PASSED_MG[pr];
                     s.eg += sign * PASSED_EG[pr];
 
-                    // blocked?
-                    int frontSq = (c == WHITE) ? make_sq(f, r + 1) : make_sq(f, r - 1);
-                    if ((unsigned)frontSq < 64u && pos.board[frontSq] != NO_PIECE) {
-                        s.mg += sign * PASSED_BLOCKED_MG;
-                        s.eg += sign * PASSED_BLOCKED_EG;
-                    }
-
                     // protected passer (by pawn)
                     bool prot = false;
                     if (c == WHITE && r > 0) {
@@ -617,19 +558,70 @@ static inline Score eval_pawns(const Position& pos, const PawnInfo& pi, int king
                     if (f <= 1 || f >= 6) {
                         s.eg += sign * OUTSIDE_PASSER_EG;
                     }
+                }
+            }
+        }
 
-                    // king distance (EG)
-                    int pawnSq = make_sq(f, r);
-                    int myK = (c == WHITE) ? kingSqW : kingSqB;
-                    int opK = (c == WHITE) ? kingSqB : kingSqW;
-                    if (myK >= 0 && opK >= 0) {
-                        int dMy = chebyshev(myK, pawnSq);
-                        int dOp = chebyshev(opK, pawnSq);
-                        s.eg += sign * clampi((dOp - dMy), -4, 4) * 3;
+        for (int f = 0; f < 8; f++) {
+            uint8_t mask = pi.ranksMask[ci][f];
+            if (mask)
+                e.semiOpen[ci] &= (uint8_t)~(1u << f);
+            while (mask) {
+                int r = low_bit(mask);
+                mask &= (uint8_t)(mask - 1);
+                e.pawnsOnColor[ci][(f + r) & 1]++;
+
+                // central squares attacked by the pawn
+                int nr = r + ((c == WHITE) ? +1 : -1);
+                if ((unsigned)nr < 8u) {
+                    for (int tf = f - 1; tf <= f + 1; tf += 2) {
+                        if ((unsigned)tf > 7u)
+                            continue;
+                        int to = make_sq(tf, nr);
+                        if (to == D4 || to == E4 || to == D5 || to == E5)
+                            s.mg += sign * CENTER_CONTROL_MG;
                     }
                 }
             }
         }
+    };
+
+    eval_color(WHITE);
+    eval_color(BLACK);
+}
+
+
+// Pawn terms that also depend on pieces and kings: blocked passers, king distance to
+// passers (EG) and the king's pawn shield (MG).
+static inline Score eval_pawns(const Position& pos, const PawnEntry& pe, int kingSqW, int kingSqB, const Weights& W) {
+    Score s{0, 0};
+
+    auto eval_color = [&](Color c) {
+        int ci = (c == WHITE) ? 0 : 1;
+        int sign = (c == WHITE) ? +1 : -1;
+
+        uint64_t passers = pe.passed[ci];
+        while (passers) {
+            int pawnSq = __builtin_ctzll(passers);
+            passers &= passers - 1;
+            int f = file_of(pawnSq), r = rank_of(pawnSq);
+
+            // blocked?
+            int frontSq = (c == WHITE) ? make_sq(f, r + 1) : make_sq(f, r - 1);
+            if ((unsigned)frontSq < 64u && pos.board[frontSq] != NO_PIECE) {
+                s.mg += sign * PASSED_BLOCKED_MG;
+                s.eg += sign * PASSED_BLOCKED_EG;
+            }
+
+            // king distance (EG)
+            int myK = (c == WHITE) ? kingSqW : kingSqB;
+            int opK = (c == WHITE) ? kingSqB : kingSqW;
+            if (myK >= 0 && opK >= 0) {
+                int dMy = chebyshev(myK, pawnSq);
+                int dOp = chebyshev(opK, pawnSq);
+                s.eg += sign * clampi((dOp - dMy), -4, 4) * 3;
+            }
+        }
 
         // king shield (MG)
         int ksq = (c == WHITE) ? kingSqW : kingSqB;
@@ -661,8 +653,192 @@ static inline Score eval_pawns(const Position& pos, const PawnInfo& pi, int king
     return s;
 }
 
+// Per-thread pawn hash: direct-mapped PawnEntry cache keyed by Position::pawnKey.
+struct PawnTable {
+    static constexpr size_t SIZE = 1u << 14; // entries, power of two
+
+    PawnEntry entries[SIZE];
+
+    inline const PawnEntry& probe(const Position& pos, bool& hit) {
+        PawnEntry& e = entries[size_t(pos.pawnKey) & (SIZE - 1)];
+        hit = (e.key == pos.pawnKey);
+        if (!hit)
+            compute_pawn_entry(pos, e);
+        return e;
+    }
+
+    inline const PawnEntry& probe(const Position& pos) {
+        bool hit;
+        return probe(pos, hit);
+    }
+};
+
+// =====================================================
+// Material hash and specialised endgames
+// =====================================================
+
+// Endgame evaluators return a white-relative score; scaling functions return a factor
+// 0..64 for the side ahead, or SCALE_NONE when the position does not qualify.
+using EndgameFn = int (*)(const Position& pos, Color strong);
+using ScaleFn = int (*)(const Position& pos, Color strong);
+
+static inline int find_piece(const Position& pos, Piece p) {
+    for (int sq = 0; sq < 64; sq++)
+        if (pos.board[sq] == p)
+            return sq;
+    return -1;
+}
+
+// Non-pawn material of one side, in MG piece values.
+static inline int non_pawn_material(const Position& pos, Color c) {
+    int v = 0;
+    for (int pt = KNIGHT; pt <= QUEEN; pt++)
+        v += piece_count(pos, c, PieceType(pt)) * MG_VAL[pt];
+    return v;
+}
+
+// KBNK: drive the lone king into a corner of the bishop's colour and bring the kings together.
+static inline int eval_kbnk(const Position& pos, Color strong) {
+    const Color weak = flip_color(strong);
+    const int sk = find_piece(pos, make_piece(strong, KING));
+    const int wk = find_piece(pos, make_piece(weak, KING));
+    const int bsq = find_piece(pos, make_piece(strong, BISHOP));
+    const bool darkBishop = ((file_of(bsq) + rank_of(bsq)) & 1) == 0;
+
+    const int cornerDist = darkBishop ? std::min(chebyshev(wk, A1), chebyshev(wk, H8))
+                                      : std::min(chebyshev(wk, H1), chebyshev(wk, A8));
+    const int v = EG_VAL[KNIGHT] + EG_VAL[BISHOP] + 400 + 40 * (7 - cornerDist) + 10 * (7 - chebyshev(sk, wk));
+    return (strong == WHITE) ? v : -v;
+}
+
+// KRKP: a win unless the defending king supports a far advanced pawn the attacking king cannot reach.
+static inline int eval_krkp(const Position& pos, Color strong) {
+    const Color weak = flip_color(strong);
+    // Squares seen from the strong side, so the pawn always runs towards rank 1.
+    auto rel = [&](int sq) { return (strong == WHITE) ? sq : (sq ^ 56); };
+    const int sk = rel(find_piece(pos, make_piece(strong, KING)));
+    const int wk = rel(find_piece(pos, make_piece(weak, KING)));
+    const int rsq = rel(find_piece(pos, make_piece(strong, ROOK)));
+    const int psq = rel(find_piece(pos, make_piece(weak, PAWN)));
+    const int queenSq = make_sq(file_of(psq), 0);
+    const bool strongToMove = (pos.side == strong);
+
+    int v;
+    if (file_of(sk) == file_of(psq) && rank_of(sk) < rank_of(psq))
+        v = EG_VAL[ROOK] - chebyshev(sk, psq);
+    else if (chebyshev(wk, psq) >= 3 + (strongToMove ? 0 : 1) && chebyshev(wk, rsq) >= 3)
+        v = EG_VAL[ROOK] - chebyshev(sk, psq);
+    else if (rank_of(wk) <= 2 && chebyshev(wk, queenSq) == 1 && rank_of(sk) >= 3 &&
+             chebyshev(sk, psq) > 2 + (strongToMove ? 1 : 0))
+        v = 80 - 8 * chebyshev(sk, psq);
+    else
+        v = 200 - 8 * (chebyshev(sk, psq - 8) - chebyshev(wk, psq - 8) - chebyshev(psq, queenSq));
+    return (strong == WHITE) ? v : -v;
+}
+
+// Bishops of opposite colours with pawns only: the EG is drawish, more so with a single extra pawn.
+static inline int scale_opposite_bishops(const Position& pos, Color strong) {
+    const int wb = find_piece(pos, W_BISHOP), bb = find_piece(pos, B_BISHOP);
+    if ((((file_of(wb) + rank_of(wb)) ^ (file_of(bb) + rank_of(bb))) & 1) == 0)
+        return SCALE_NONE;
+    const int pawnDiff = piece_count(pos, strong, PAWN) - piece_count(pos, flip_color(strong), PAWN);
+    return (pawnDiff <= 1) ? 16 : 32;
+}
+
+// Everything that depends on the material signature alone.
+struct MaterialEntry {
+    uint64_t key = 0;
+    int phase = 0;
+    Score imbalance{0, 0}; // white-relative
+    EndgameFn evalFn = nullptr;
+    Color evalStrong = WHITE;
+    ScaleFn scaleFn[2] = {nullptr, nullptr}; // [side ahead]
+    uint8_t factor[2] = {SCALE_NORMAL, SCALE_NORMAL};
+
+    inline int scale_factor(const Position& pos, Color c) const {
+        const int ci = (c == WHITE) ? 0 : 1;
+        if (scaleFn[ci]) {
+            const int sf = scaleFn[ci](pos, c);
+            if (sf != SCALE_NONE)
+                return sf;
+        }
+        return factor[ci];
+    }
+};
+
+static inline void compute_material_entry(const Position& pos, MaterialEntry& e) {
+    e = MaterialEntry{};
+    e.key = pos.materialKey;
+    e.phase = game_phase_256(pos);
+
+    int cnt[2][7];
+    for (Color c : {WHITE, BLACK})
+        for (int pt = PAWN; pt <= KING; pt++)
+            cnt[c][pt] = piece_count(pos, c, PieceType(pt));
+
+    for (Color c : {WHITE, BLACK}) {
+        const int sign = (c == WHITE) ? +1 : -1;
+        if (cnt[c][BISHOP] >= 2) {
+            e.imbalance.mg += sign * BISHOP_PAIR_MG;
+            e.imbalance.eg += sign * BISHOP_PAIR_EG;
+        }
+        const int pawnsAbove5 = cnt[c][PAWN] - 5;
+        const int adj = pawnsAbove5 * (cnt[c][KNIGHT] * KNIGHT_PAWN_ADJ - cnt[c][ROOK] * ROOK_PAWN_ADJ);
+        e.imbalance.mg += sign * adj;
+        e.imbalance.eg += sign * adj;
+    }
+
+    auto only = [&](Color c, int p, int n, int b, int r, int q) {
+        return cnt[c][PAWN] == p && cnt[c][KNIGHT] == n && cnt[c][BISHOP] == b && cnt[c][ROOK] == r &&
+               cnt[c][QUEEN] == q;
+    };
+
+    for (Color c : {WHITE, BLACK}) {
+        const Color o = flip_color(c);
+        if (only(c, 0, 1, 1, 0, 0) && only(o, 0, 0, 0, 0, 0)) {
+            e.evalFn = eval_kbnk;
+            e.evalStrong = c;
+            return;
+        }
+        if (only(c, 0, 0, 0, 1, 0) && only(o, 1, 0, 0, 0, 0)) {
+            e.evalFn = eval_krkp;
+            e.evalStrong = c;
+            return;
+        }
+    }
+
+    if (cnt[WHITE][BISHOP] == 1 && cnt[BLACK][BISHOP] == 1 && only(WHITE, cnt[WHITE][PAWN], 0, 1, 0, 0) &&
+        only(BLACK, cnt[BLACK][PAWN], 0, 1, 0, 0)) {
+        e.scaleFn[0] = e.scaleFn[1] = scale_opposite_bishops;
+    }
+
+    // Without pawns, a lead of at most a minor piece rarely wins.
+    const int npm[2] = {non_pawn_material(pos, WHITE), non_pawn_material(pos, BLACK)};
+    for (Color c : {WHITE, BLACK}) {
+        const Color o = flip_color(c);
+        if (cnt[c][PAWN] == 0 && npm[c] - npm[o] <= MG_VAL[BISHOP])
+            e.factor[c] = (npm[c] < MG_VAL[ROOK]) ? 0 : (npm[o] <= MG_VAL[BISHOP] ? 4 : 14);
+        if (only(c, 0, 2, 0, 0, 0) && only(o, 0, 0, 0, 0, 0))
+            e.factor[c] = 0; // KNNK
+    }
+}
+
+// Per-thread material hash: direct-mapped MaterialEntry cache keyed by Position::materialKey.
+struct MaterialTable {
+    static constexpr size_t SIZE = 1u << 13; // entries, power of two
+
+    MaterialEntry entries[SIZE];
+
+    inline const MaterialEntry& probe(const Position& pos) {
+        MaterialEntry& e = entries[size_t(pos.materialKey) & (SIZE - 1)];
+        if (e.key != pos.materialKey)
+            compute_material_entry(pos, e);
+        return e;
+    }
+};
+
 // King safety based on attack counts and open files.
-static inline Score eval_king_safety(const Position& pos, const PawnInfo& pi, const AttackInfo& ai, int kingSqW,
+static inline Score eval_king_safety(const Position& pos, const PawnEntry& pe, const AttackInfo& ai, int kingSqW,
                                      int kingSqB, int phase, const Weights& W) {
     Score s{0, 0};
     if (phase < 96)
@@ -698,8 +874,8 @@ static inline Score eval_king_safety(const Position& pos, const PawnInfo& pi, co
         for (int ff = kf - 1; ff <= kf + 1; ff++) {
             if ((unsigned)ff > 7u)
                 continue;
-            bool defPawn = pi.fileCount[di][ff] > 0;
-            bool atkPawn = pi.fileCount[aiC][ff] > 0;
+            bool defPawn = !(pe.semiOpen[di] & (1u << ff));
+            bool atkPawn = !(pe.semiOpen[aiC] & (1u << ff));
             if (!defPawn) {
                 openScore += atkPawn ? W.ksSemiOpenMG : W.ksOpenFileMG;
             }
@@ -733,14 +909,13 @@ static inline Score eval_king_safety(const Position& pos, const PawnInfo& pi, co
 }
 
 // Piece activity and mobility (rooks, minors, queen).
-static inline Score eval_pieces(const Position& pos, const PawnInfo& pi, const AttackInfo& /*ai*/, int /*kingSqW*/,
+static inline Score eval_pieces(const Position& pos, const PawnEntry& pe, const AttackInfo& /*ai*/, int /*kingSqW*/,
                                 int /*kingSqB*/) {
     Score s{0, 0};
 
     static const int DIR_B[8] = {1, 1, 1, -1, -1, 1, -1, -1};
     static const int DIR_R[8] = {1, 0, -1, 0, 0, 1, 0, -1};
 
-    int bishopCount[2] = {0, 0};
     int rookSq[2][2] = {{-1, -1}, {-1, -1}};
     int rookN[2] = {0, 0};
 
@@ -794,7 +969,7 @@ static inline Score eval_pieces(const Position& pos, const PawnInfo& pi, const A
         auto enemyPawnCouldChase = [&](int ff) -> bool {
             if ((unsigned)ff > 7u)
                 return false;
-            uint8_t m = pi.ranksMask[(opp == WHITE) ? 0 : 1][ff];
+            uint8_t m = pe.pi.ranksMask[(opp == WHITE) ? 0 : 1][ff];
             if (!m)
                 return false;
             if (opp == WHITE) {
@@ -816,18 +991,8 @@ static inline Score eval_pieces(const Position& pos, const PawnInfo& pi, const A
     auto bishop_color_pen = [&](Color c, int bishopSq) -> Score {
         int ci = (c == WHITE) ? 0 : 1;
         int sign = (c == WHITE) ? +1 : -1;
-        bool dark = ((file_of(bishopSq) + rank_of(bishopSq)) & 1) == 1;
-        int cnt = 0;
-        for (int f = 0; f < 8; f++) {
-            uint8_t m = pi.ranksMask[ci][f];
-            while (m) {
-                int r = low_bit(m);
-                m &= (uint8_t)(m - 1);
-                bool pdark = ((f + r) & 1) == 1;
-                if (pdark == dark)
-                    cnt++;
-            }
-        }
+        int dark = (file_of(bishopSq) + rank_of(bishopSq)) & 1;
+        int cnt = pe.pawnsOnColor[ci][dark];
         int pen = clampi(cnt - 4, 0, 6);
         return {-sign * pen * BAD_BISHOP_MG, -sign * pen * BAD_BISHOP_EG};
     };
@@ -849,40 +1014,8 @@ static inline Score eval_pieces(const Position& pos, const PawnInfo& pi, const A
             continue;
         Color c = color_of(p);
         int sign = (c == WHITE) ? +1 : -1;
-        int sqq = (c == WHITE) ? sq : mirror_sq(sq);
         PieceType pt = type_of(p);
 
-        Score base{sign * MG_VAL[(int)pt], sign * EG_VAL[(int)pt]};
-        switch (pt) {
-        case PAWN:
-            base.mg += sign * PST_P_MG[sqq];
-            base.eg += sign * PST_P_EG[sqq];
-            break;
-        case KNIGHT:
-            base.mg += sign * PST_N_MG[sqq];
-            base.eg += sign * PST_N_EG[sqq];
-            break;
-        case BISHOP:
-            base.mg += sign * PST_B_MG[sqq];
-            base.eg += sign * PST_B_EG[sqq];
-            break;
-        case ROOK:
-            base.mg += sign * PST_R_MG[sqq];
-            base.eg += sign * PST_R_EG[sqq];
-            break;
-        case QUEEN:
-            base.mg += sign * PST_Q_MG[sqq];
-            base.eg += sign * PST_Q_EG[sqq];
-            break;
-        case KING:
-            base.mg += sign * PST_K_MG[sqq];
-            base.eg += sign * PST_K_EG[sqq];
-            break;
-        default:
-            break;
-        }
-        s += base;
-
         if (pt == KNIGHT) {
             int mob = mobility_knight(pos, c, sq);
             s.mg += sign * mob * MOB_N_MG;
@@ -904,7 +1037,6 @@ static inline Score eval_pieces(const Position& pos, const PawnInfo& pi, const A
             s.eg += sign * mob * MOB_B_EG;
 
             s += bishop_color_pen(c, sq);
-            bishopCount[(c == WHITE) ? 0 : 1]++;
         } else if (pt == ROOK) {
             int mob = mobility_slider(pos, c, sq, DIR_R, 4);
             s.mg += sign * mob * MOB_R_MG;
@@ -915,8 +1047,8 @@ static inline Score eval_pieces(const Position& pos, const PawnInfo& pi, const A
                 rookSq[ci][rookN[ci]++] = sq;
 
             int f = file_of(sq);
-            bool ownPawn = pi.fileCount[ci][f] > 0;
-            bool oppPawn = pi.fileCount[ci ^ 1][f] > 0;
+            bool ownPawn = !(pe.semiOpen[ci] & (1u << f));
+            bool oppPawn = !(pe.semiOpen[ci ^ 1] & (1u << f));
             if (!ownPawn && !oppPawn)
                 s.mg += sign * ROOK_OPEN_FILE_MG;
             else if (!ownPawn && oppPawn)
@@ -933,34 +1065,9 @@ static inline Score eval_pieces(const Position& pos, const PawnInfo& pi, const A
             s.eg += sign * mob * MOB_Q_EG;
 
             s.mg -= sign * early_queen_pen(c, sq);
-        } else if (pt == PAWN) {
-            int f = file_of(sq), r = rank_of(sq);
-            int dr = (c == WHITE) ? +1 : -1;
-            int nr = r + dr;
-            if ((unsigned)nr < 8u) {
-                if (f > 0) {
-                    int to = make_sq(f - 1, nr);
-                    if (to == D4 || to == E4 || to == D5 || to == E5)
-                        s.mg += sign * CENTER_CONTROL_MG;
-                }
-                if (f < 7) {
-                    int to = make_sq(f + 1, nr);
-                    if (to == D4 || to == E4 || to == D5 || to == E5)
-                        s.mg += sign * CENTER_CONTROL_MG;
-                }
-            }
         }
     }
 
-    if (bishopCount[0] >= 2) {
-        s.mg += BISHOP_PAIR_MG;
-        s.eg += BISHOP_PAIR_EG;
-    }
-    if (bishopCount[1] >= 2) {
-        s.mg -= BISHOP_PAIR_MG;
-        s.eg -= BISHOP_PAIR_EG;
-    }
-
     for (int ci = 0; ci < 2; ci++) {
         if (rookSq[ci][0] >= 0 && rookSq[ci][1] >= 0) {
             int a = rookSq[ci][0], b = rookSq[ci][1];
@@ -979,8 +1086,9 @@ static inline Score eval_pieces(const Position& pos, const PawnInfo& pi, const A
     return s;
 }
 
-// Main evaluation entry: blends MG/EG by phase and applies tempo.
-inline int evaluate(const Position& pos) {
+// Evaluation given the position's pawn and material entries: blends MG/EG by phase,
+// scales the EG term for drawish material and applies tempo.
+static inline int evaluate(const Position& pos, const PawnEntry& pe, const MaterialEntry& me) {
     int kingW = -1, kingB = -1;
     for (int sq = 0; sq < 64; sq++) {
         Piece p = pos.board[sq];
@@ -994,18 +1102,21 @@ inline int evaluate(const Position& pos) {
         }
     }
 
-    int phase = game_phase_256(pos);
+    const int phase = me.phase;
 
-    PawnInfo pi = gather_pawns(pos);
     AttackInfo ai = compute_attacks(pos);
 
     const Weights W = weights_for(pos.side);
 
-    Score total{0, 0};
+    Score total = Score{pos.psqMg, pos.psqEg} + pe.score + me.imbalance;
+
+    total += eval_pieces(pos, pe, ai, kingW, kingB);
+    total += eval_pawns(pos, pe, kingW, kingB, W);
+    total += eval_king_safety(pos, pe, ai, kingW, kingB, phase, W);
 
-    total += eval_pieces(pos, pi, ai, kingW, kingB);
-    total += eval_pawns(pos, pi, kingW, kingB, W);
-    total += eval_king_safety(pos, pi, ai, kingW, kingB, phase, W);
+    const int sf = me.scale_factor(pos, total.eg > 0 ? WHITE : BLACK);
+    if (sf != SCALE_NORMAL)
+        total.eg = total.eg * sf / SCALE_NORMAL;
 
     int score = (total.mg * phase + total.eg * (256 - phase)) / 256;
 
@@ -1016,4 +1127,37 @@ inline int evaluate(const Position& pos) {
     return (pos.side == WHITE) ? score : -score;
 }
 
+// Main evaluation entry for search threads, with pawn and material terms served by their
+// hashes. Material with a known endgame evaluator skips the general evaluation (and the
+// pawn table); otherwise onPawnProbe(hit) reports how the pawn entry was served.
+template <typename OnPawnProbe>
+inline int evaluate(const Position& pos, PawnTable& pawns, MaterialTable& material, OnPawnProbe&& onPawnProbe) {
+    const MaterialEntry& me = material.probe(pos);
+    if (me.evalFn) {
+        const int v = me.evalFn(pos, me.evalStrong);
+        return (pos.side == WHITE) ? v : -v;
+    }
+    bool hit;
+    const PawnEntry& pe = pawns.probe(pos, hit);
+    onPawnProbe(hit);
+    return evaluate(pos, pe, me);
+}
+
+inline int evaluate(const Position& pos, PawnTable& pawns, MaterialTable& material) {
+    return evaluate(pos, pawns, material, [](bool) {});
+}
+
+// Uncached evaluation for callers without their own tables.
+inline int evaluate(const Position& pos) {
+    MaterialEntry me;
+    compute_material_entry(pos, me);
+    if (me.evalFn) {
+        const int v = me.evalFn(pos, me.evalStrong);
+        return (pos.side == WHITE) ? v : -v;
+    }
+    PawnEntry pe;
+    compute_pawn_entry(pos, pe);
+    return evaluate(pos, pe, me);
+}
+
 } // namespace eval
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+
+#include "types.h"
+
+namespace eval {
+
+// Material values and piece-square tables, white's view with a1 = 0. Position keeps
+// running totals of them (Position::psqMg/psqEg), so evaluate never re-sums the board.
+
+// =====================================================
+// Material values (MG/EG)
+// =====================================================
+static constexpr int MG_VAL[7] = {0, 100, 320, 330, 500, 900, 0};
+static constexpr int EG_VAL[7] = {0, 120, 300, 320, 520, 900, 0};
+
+// =====================================================
+// PSQT (MG/EG)
+// =====================================================
+static constexpr int PST_P_MG[64] = {0,  0,  0,   0,  0,  0,   0,  0,  5,  10, 10, -20, -20, 10, 10, 5,
+                                     5,  -5, -10, 0,  0,  -10, -5, 5,  0,  0,  0,  20,  20,  0,  0,  0,
+                                     5,  5,  10,  25, 25, 10,  5,  5,  10, 10, 20, 30,  30,  20, 10, 10,
+                                     50, 50, 50,  50, 50, 50,  50, 50, 0,  0,  0,  0,   0,   0,  0,  0};
+static constexpr int PST_P_EG[64] = {0, 0, 0, 0, 0,  0,  0,  0,  10, 10, 10, 10, 10, 10, 10, 10, 8, 8, 8, 12, 12, 8,
+                                     8, 8, 6, 6, 10, 14, 14, 10, 6,  6,  4,  4,  6,  10, 10, 6,  4, 4, 2, 2,  2,  6,
+                                     6, 2, 2, 2, 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 0, 0, 0};
+
+static constexpr int PST_N_MG[64] = {-50, -40, -30, -30, -30, -30, -40, -50, -40, -20, 0,   5,   5,   0,   -20, -40,
+                                     -30, 5,   10,  15,  15,  10,  5,   -30, -30, 0,   15,  20,  20,  15,  0,   -30,
+                                     -30, 5,   15,  20,  20,  15,  5,   -30, -30, 0,   10,  15,  15,  10,  0,   -30,
+                                     -40, -20, 0,   0,   0,   0,   -20, -40, -50, -40, -30, -30, -30, -30, -40, -50};
+static constexpr int PST_N_EG[64] = {-40, -25, -20, -15, -15, -20, -25, -40, -25, -10, 0,   5,   5,   0,   -10, -25,
+                                     -20, 5,   10,  15,  15,  10,  5,   -20, -15, 5,   15,  20,  20,  15,  5,   -15,
+                                     -15, 5,   15,  20,  20,  15,  5,   -15, -20, 5,   10,  15,  15,  10,  5,   -20,
+                                     -25, -10, 0,   5,   5,   0,   -10, -25, -40, -25, -20, -15, -15, -20, -25, -40};
+
+static constexpr int PST_B_MG[64] = {-20, -10, -10, -10, -10, -10, -10, -20, -10, 5,   0,   0,   0,   0,   5,   -10,
+                                     -10, 10,  10,  10,  10,  10,  10,  -10, -10, 0,   10,  10,  10,  10,  0,   -10,
+                                     -10, 5,   5,   10,  10,  5,   5,   -10, -10, 0,   5,   10,  10,  5,   0,   -10,
+                                     -10, 0,   0,   0,   0,   0,   0,   -10, -20, -10, -10, -10, -10, -10, -10, -20};
+static constexpr int PST_B_EG[64] = {-10, -5, -5, -5, -5, -5, -5, -10, -5,  5,  0,  0,  0,  0,  5,  -5,
+                                     -5,  8,  10, 10, 10, 10, 8,  -5,  -5,  0,  10, 12, 12, 10, 0,  -5,
+                                     -5,  0,  10, 12, 12, 10, 0,  -5,  -5,  8,  10, 10, 10, 10, 8,  -5,
+                                     -5,  5,  0,  0,  0,  0,  5,  -5,  -10, -5, -5, -5, -5, -5, -5, -10};
+
+static constexpr int PST_R_MG[64] = {0, 0,  5,  10, 10, 5,  0,  0,  -5, 0,  0,  0, 0, 0, 0, -5, -5, 0,  0,  0, 0, 0,
+                                     0, -5, -5, 0,  0,  0,  0,  0,  0,  -5, -5, 0, 0, 0, 0, 0,  0,  -5, -5, 0, 0, 0,
+                                     0, 0,  0,  -5, 5,  10, 10, 10, 10, 10, 10, 5, 0, 0, 0, 2,  2,  0,  0,  0};
+static constexpr int PST_R_EG[64] = {0,  0, 5, 8, 8, 5,  0,  0, 0, 5, 8, 10, 10, 8,  5,  0, 0, 5, 8, 10, 10, 8,
+                                     5,  0, 0, 5, 8, 10, 10, 8, 5, 0, 0, 5,  8,  10, 10, 8, 5, 0, 0, 5,  8,  10,
+                                     10, 8, 5, 0, 0, 0,  5,  8, 8, 5, 0, 0,  0,  0,  0,  3, 3, 0, 0, 0};
+
+static constexpr int PST_Q_MG[64] = {-20, -10, -10, -5, -5, -10, -10, -20, -10, 0,   0,   0,  0,  0,   0,   -10,
+                                     -10, 0,   5,   5,  5,  5,   0,   -10, -5,  0,   5,   5,  5,  5,   0,   -5,
+                                     0,   0,   5,   5,  5,  5,   0,   -5,  -10, 5,   5,   5,  5,  5,   0,   -10,
+                                     -10, 0,   5,   0,  0,  0,   0,   -10, -20, -10, -10, -5, -5, -10, -10, -20};
+static constexpr int PST_Q_EG[64] = {-10, -5, -5, -2, -2, -5, -5, -10, -5,  0,  0,  0,  0,  0,  0,  -5,
+                                     -5,  0,  3,  3,  3,  3,  0,  -5,  -2,  0,  3,  4,  4,  3,  0,  -2,
+                                     -2,  0,  3,  4,  4,  3,  0,  -2,  -5,  0,  3,  3,  3,  3,  0,  -5,
+                                     -5,  0,  0,  0,  0,  0,  0,  -5,  -10, -5, -5, -2, -2, -5, -5, -10};
+
+static constexpr int PST_K_MG[64] = {-30, -40, -40, -50, -50, -40, -40, -30, -30, -40, -40, -50, -50, -40, -40, -30,
+                                     -30, -40, -40, -50, -50, -40, -40, -30, -30, -40, -40, -50, -50, -40, -40, -30,
+                                     -20, -30, -30, -40, -40, -30, -30, -20, -10, -20, -20, -20, -20, -20, -20, -10,
+                                     20,  20,  0,   0,   0,   0,   20,  20,  20,  30,  10,  0,   0,   10,  30,  20};
+static constexpr int PST_K_EG[64] = {-50, -30, -30, -30, -30, -30, -30, -50, -30, -10, 0,   0,   0,   0,   -10, -30,
+                                     -30, 0,   10,  15,  15,  10,  0,   -30, -30, 0,   15,  20,  20,  15,  0,   -30,
+                                     -30, 0,   15,  20,  20,  15,  0,   -30, -30, 0,   10,  15,  15,  10,  0,   -30,
+                                     -30, -10, 0,   0,   0,   0,   -10, -30, -50, -30, -30, -30, -30, -30, -30, -50};
+
+// Phase weight per piece type: N/B 1, R 2, Q 4 (24 with all pieces on the board).
+static constexpr int PHASE_WEIGHT[7] = {0, 0, 1, 1, 2, 4, 0};
+
+// Signed material + PST per encoded piece and square (black negated and mirrored).
+struct PsqTable {
+    int mg[16][64]{};
+    int eg[16][64]{};
+};
+
+constexpr PsqTable make_psq_table() {
+    const int* pstMg[7] = {nullptr, PST_P_MG, PST_N_MG, PST_B_MG, PST_R_MG, PST_Q_MG, PST_K_MG};
+    const int* pstEg[7] = {nullptr, PST_P_EG, PST_N_EG, PST_B_EG, PST_R_EG, PST_Q_EG, PST_K_EG};
+    PsqTable t{};
+    for (int pt = PAWN; pt <= KING; pt++) {
+        for (int sq = 0; sq < 64; sq++) {
+            t.mg[pt][sq] = MG_VAL[pt] + pstMg[pt][sq];
+            t.eg[pt][sq] = EG_VAL[pt] + pstEg[pt][sq];
+            t.mg[pt + 8][sq] = -(MG_VAL[pt] + pstMg[pt][sq ^ 56]);
+            t.eg[pt + 8][sq] = -(EG_VAL[pt] + pstEg[pt][sq ^ 56]);
+        }
+    }
+    return t;
+}
+
+inline constexpr PsqTable PSQ = make_psq_table();
+
+} // namespace eval
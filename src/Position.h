@@ -7,6 +7,7 @@
 
 #include "types.h"
 #include "ZobristTables.h"
+#include "PieceSquare.h"
 
 // Position representation and move make/undo with incremental Zobrist.
 
@@ -31,7 +32,14 @@ struct Undo {
     int prevHalfmove = 0;
     int prevFullmove = 1;
 
-    uint64_t prevKey = 0; // zobrist before move
+    uint64_t prevKey = 0;     // zobrist before move
+    uint64_t prevPawnKey = 0; // pawn key before move
+    uint64_t prevMaterialKey = 0;
+
+    // Material + PST and phase accumulators before move.
+    int prevPsqMg = 0;
+    int prevPsqEg = 0;
+    int prevPhase = 0;
 
     // En passant capture square (if any).
     int epCapturedSq = -1;
@@ -51,7 +59,17 @@ struct Position {
     int halfmoveClock = 0;
     int fullmoveNumber = 1;
 
-    uint64_t zobKey = 0; // incremental Zobrist key
+    uint64_t zobKey = 0;  // incremental Zobrist key
+    uint64_t pawnKey = 0; // incremental Zobrist key of the pawns alone (pawn hash)
+
+    // Piece counts and the material signature key (XOR of matKey[p][i] for i < count of p).
+    uint8_t pieceCount[16]{};
+    uint64_t materialKey = 0;
+
+    // Running white-relative sums of material + PST (eval::PSQ) and of phase weights.
+    int psqMg = 0;
+    int psqEg = 0;
+    int phaseWeight = 0;
 
     Position() {
         clear();
@@ -126,6 +144,7 @@ struct Position {
     // Full Zobrist recompute; used at init or for debugging.
     inline void recompute_zobrist() {
         uint64_t k = 0;
+        uint64_t pk = 0;
         for (int sq = 0; sq < 64; sq++) {
             Piece p = board[sq];
             if (p == NO_PIECE)
@@ -134,6 +153,24 @@ struct Position {
             if ((unsigned)pi >= 16u)
                 continue;
             k ^= g_zob.psq[pi][sq];
+            if (type_of(p) == PAWN)
+                pk ^= g_zob.psq[pi][sq];
+        }
+        pawnKey = pk;
+        materialKey = 0;
+        for (int p = 0; p < 16; p++)
+            pieceCount[p] = 0;
+        for (int sq = 0; sq < 64; sq++) {
+            const int p = (int)board[sq] & 15;
+            if (board[sq] != NO_PIECE && pieceCount[p] < 16)
+                materialKey ^= g_zob.matKey[p][pieceCount[p]++];
+        }
+        psqMg = psqEg = phaseWeight = 0;
+        for (int sq = 0; sq < 64; sq++) {
+            const int p = (int)board[sq] & 15;
+            psqMg += eval::PSQ.mg[p][sq];
+            psqEg += eval::PSQ.eg[p][sq];
+            phaseWeight += eval::PHASE_WEIGHT[type_of(board[sq])];
         }
         if (side == BLACK)
             k ^= g_zob.sideKey;
@@ -207,6 +244,61 @@ struct Position {
         zobKey = k;
     }
 
+    // Zobrist key of the position after m, computed from the current board without
+    // making the move (same deltas as apply_zobrist_delta_after_move). Used to start the
+    // child's TT fetch before do_move.
+    inline uint64_t key_after(Move m) const {
+        const int from = from_sq(m);
+        const int to = to_sq(m);
+        const Piece moved = board[from];
+        const PieceType movedType = type_of(moved);
+        const Piece captured = board[to];
+        uint64_t k = zobKey ^ g_zob.sideKey;
+
+        int cr = castlingRights;
+        auto rook_corner = [&cr](int sq) {
+            if (sq == H1)
+                cr &= ~CR_WK;
+            else if (sq == A1)
+                cr &= ~CR_WQ;
+            else if (sq == H8)
+                cr &= ~CR_BK;
+            else if (sq == A8)
+                cr &= ~CR_BQ;
+        };
+        if (movedType == KING)
+            cr &= (side == WHITE) ? ~(CR_WK | CR_WQ) : ~(CR_BK | CR_BQ);
+        else if (movedType == ROOK)
+            rook_corner(from);
+        if (captured != NO_PIECE && type_of(captured) == ROOK)
+            rook_corner(to);
+        k ^= g_zob.castleKey[castlingRights & 15] ^ g_zob.castleKey[cr & 15];
+
+        if (epSquare != -1)
+            k ^= g_zob.epKey[file_of(epSquare) & 7];
+        if (movedType == PAWN && std::abs(to - from) == 16)
+            k ^= g_zob.epKey[file_of(from) & 7];
+
+        Piece finalP = moved;
+        if (flags_of(m) & MF_EP) {
+            const int capSq = (side == WHITE) ? (to - 8) : (to + 8);
+            k ^= g_zob.psq[(int)board[capSq] & 15][capSq];
+        } else if (flags_of(m) & MF_CASTLE) {
+            const int rookFrom = (to > from) ? from + 3 : from - 4;
+            const int rookTo = (to > from) ? from + 1 : from - 1;
+            const int rook = (int)make_piece(side, ROOK);
+            k ^= g_zob.psq[rook][rookFrom] ^ g_zob.psq[rook][rookTo];
+        } else {
+            if (captured != NO_PIECE)
+                k ^= g_zob.psq[(int)captured & 15][to];
+            const int promo = promo_of(m);
+            if (promo && movedType == PAWN)
+                finalP = make_piece(side, promo == 1 ? KNIGHT : promo == 2 ? BISHOP : promo == 3 ? ROOK : QUEEN);
+        }
+        k ^= g_zob.psq[(int)moved & 15][from] ^ g_zob.psq[(int)finalP & 15][to];
+        return k;
+    }
+
     // Standard initial position.
     void set_startpos() {
         clear();
@@ -337,6 +429,11 @@ struct Position {
         u.prevHalfmove = halfmoveClock;
         u.prevFullmove = fullmoveNumber;
         u.prevKey = zobKey; // base for fast undo and incremental key update
+        u.prevPawnKey = pawnKey;
+        u.prevMaterialKey = materialKey;
+        u.prevPsqMg = psqMg;
+        u.prevPsqEg = psqEg;
+        u.prevPhase = phaseWeight;
 
         const int from = from_sq(m);
         const int to = to_sq(m);
@@ -460,6 +557,42 @@ struct Position {
 
         apply_zobrist_delta_after_move(u, m);
 
+        // Pawn key: the pawn that moved (unless it promoted) and a captured pawn.
+        if (movedType == PAWN) {
+            pawnKey ^= g_zob.psq[(int)movedPiece & 15][from];
+            if (board[to] == movedPiece)
+                pawnKey ^= g_zob.psq[(int)movedPiece & 15][to];
+        }
+        if (u.captured != NO_PIECE && type_of(u.captured) == PAWN)
+            pawnKey ^= g_zob.psq[(int)u.captured & 15][u.epCapturedSq != -1 ? u.epCapturedSq : to];
+
+        // Material: a capture removes one piece, a promotion turns a pawn into another piece.
+        if (u.captured != NO_PIECE) {
+            const int c = (int)u.captured & 15;
+            materialKey ^= g_zob.matKey[c][--pieceCount[c]];
+        }
+        if (board[to] != movedPiece) {
+            const int p = (int)movedPiece & 15, q = (int)board[to] & 15;
+            materialKey ^= g_zob.matKey[p][--pieceCount[p]];
+            materialKey ^= g_zob.matKey[q][pieceCount[q]++];
+            phaseWeight += eval::PHASE_WEIGHT[type_of(board[to])];
+        }
+
+        // Material + PST: the mover (as promoted) changes square, a captured piece and a castling rook too.
+        psqMg += eval::PSQ.mg[(int)board[to]][to] - eval::PSQ.mg[(int)movedPiece][from];
+        psqEg += eval::PSQ.eg[(int)board[to]][to] - eval::PSQ.eg[(int)movedPiece][from];
+        if (u.captured != NO_PIECE) {
+            const int capSq = (u.epCapturedSq != -1) ? u.epCapturedSq : to;
+            psqMg -= eval::PSQ.mg[(int)u.captured][capSq];
+            psqEg -= eval::PSQ.eg[(int)u.captured][capSq];
+            phaseWeight -= eval::PHASE_WEIGHT[type_of(u.captured)];
+        }
+        if (u.rookTo != -1) {
+            const int rook = (int)board[u.rookTo];
+            psqMg += eval::PSQ.mg[rook][u.rookTo] - eval::PSQ.mg[rook][u.rookFrom];
+            psqEg += eval::PSQ.eg[rook][u.rookTo] - eval::PSQ.eg[rook][u.rookFrom];
+        }
+
         return u;
     }
 
@@ -475,6 +608,18 @@ struct Position {
 
         side = u.prevSide; // do not infer; use saved side
 
+        // Material counts: the captured piece returns, a promoted piece reverts to the pawn.
+        if (u.captured != NO_PIECE)
+            pieceCount[(int)u.captured & 15]++;
+        if (board[to] != u.moved) {
+            pieceCount[(int)board[to] & 15]--;
+            pieceCount[(int)u.moved & 15]++;
+        }
+        materialKey = u.prevMaterialKey;
+        psqMg = u.prevPsqMg;
+        psqEg = u.prevPsqEg;
+        phaseWeight = u.prevPhase;
+
         // --- undo castling rook move ---
         if (u.rookFrom != -1 && u.rookTo != -1) {
             board[u.rookFrom] = board[u.rookTo];
@@ -487,6 +632,7 @@ struct Position {
             board[to] = NO_PIECE; // EP target square was empty
             board[u.epCapturedSq] = u.captured;
             zobKey = u.prevKey; // fast restore key
+            pawnKey = u.prevPawnKey;
             return;
         }
 
@@ -495,6 +641,30 @@ struct Position {
         board[to] = u.captured;
 
         zobKey = u.prevKey; // fast restore key (always correct)
+        pawnKey = u.prevPawnKey;
+    }
+
+    // Dead-drawn material: bare kings, a single minor, or bishops all on one square color.
+    bool has_insufficient_material() const {
+        // Piece counts decide all but the bishops-only case, so most nodes return here.
+        for (Color c : {WHITE, BLACK}) {
+            const int base = (c == WHITE) ? 0 : 8;
+            if (pieceCount[base + PAWN] || pieceCount[base + ROOK] || pieceCount[base + QUEEN])
+                return false;
+        }
+        const int knights = pieceCount[W_KNIGHT] + pieceCount[B_KNIGHT];
+        const int bishops = pieceCount[W_BISHOP] + pieceCount[B_BISHOP];
+        if (knights + bishops <= 1)
+            return true;
+        if (knights)
+            return false;
+
+        int bishopColors = 0; // bit 0 light, bit 1 dark
+        for (int sq = 0; sq < 64; sq++) {
+            if (board[sq] == W_BISHOP || board[sq] == B_BISHOP)
+                bishopColors |= ((file_of(sq) + rank_of(sq)) & 1) ? 1 : 2;
+        }
+        return bishopColors != 3;
     }
 
     // For debugging / sanity
@@ -9,8 +9,10 @@
 #include <atomic>
 #include <thread>
 #include <memory>
+#include <type_traits>
 #include <tuple>
 #include <mutex>
+#include <condition_variable>
 
 #include "types.h"
 #include "Position.h"
@@ -22,6 +24,9 @@
 #include "search/SearchMoveFormat.h"
 #include "search/SearchStats.h"
 #include "search/SearchTiming.h"
+#include "search/SearchTimeManager.h"
+#include "search/SearchNuma.h"
+#include "search/SearchEvalCache.h"
 #include "search/SearchUtils.h"
 #include "TT.h"
 #include "see_full.h"
@@ -60,6 +65,7 @@ struct Limits {
     int movetime_ms = 0;
     int optimum_ms = 0;
     bool infinite = false;
+    bool ponder = false; // timer already armed by the caller; ponderhit may re-arm it at any time
 };
 
 struct Result {
@@ -67,6 +73,8 @@ struct Result {
     Move ponderMove = 0; // PV[1], or 0 if unknown
     int score = 0;
     uint64_t nodes = 0;
+    int depth = 0; // last completed iteration
+    std::vector<Move> pv; // legal PV of the last completed iteration
 };
 
 // =====================================
@@ -75,15 +83,15 @@ struct Result {
 
 // Approximate hash occupancy by sampling a fixed prefix.
 inline int hashfull_permille_fallback(const TT& tt) {
-    if (tt.table.empty())
+    if (tt.empty())
         return 0;
 
-    const size_t N = tt.table.size();
+    const size_t N = tt.size();
     const size_t SAMPLE = std::min<size_t>(N, 1u << 15);
 
     size_t filled = 0;
     for (size_t i = 0; i < SAMPLE; i++) {
-        if (tt.table[i].key != 0)
+        if (tt.table[i].depth >= 0) // eval-only entries (depth -1) hold no search result
             filled++;
     }
     return int((filled * 1000ULL) / SAMPLE);
@@ -96,17 +104,29 @@ struct SharedTT {
     static constexpr int LOCKS = 4096; // power of two
     std::vector<std::mutex> locks;
 
-    SharedTT() : locks(LOCKS) {}
+    // ABDADA: zobrist keys of positions some thread is searching right now. A lost
+    // or overwritten marker only costs a duplicated search, never correctness.
+    static constexpr size_t BUSY_SLOTS = 1u << 15; // power of two
+    std::unique_ptr<std::atomic<uint64_t>[]> busy;
 
-    inline int lock_index(uint64_t key) const { return int((key ^ (key >> 32)) & (LOCKS - 1)); }
+    SharedTT() : locks(LOCKS), busy(new std::atomic<uint64_t>[BUSY_SLOTS]) {
+        for (size_t i = 0; i < BUSY_SLOTS; i++)
+            busy[i].store(0, std::memory_order_relaxed);
+    }
+    ~SharedTT() { wait_clear(); }
+
+    // Derived from the slot index, so every writer of one slot takes the same lock.
+    inline int lock_index(uint64_t key) const { return int(key & tt.mask & (LOCKS - 1)); }
 
-    // Lock-free read copy; may be slightly stale.
+    // Lock-free read copy of a search result; may be slightly stale. Eval-only entries
+    // (depth -1) carry no bound and do not count as a hit.
     inline bool probe_copy(uint64_t key, TTEntry& out) {
-        TTEntry* e = tt.probe(key);
-        if (!e || e->key != key)
+        const TTEntry* e = tt.probe(key);
+        if (e->key != TT::verify_key(key) || e->depth < 0)
             return false;
         // Read only hot fields needed by search, avoid whole-struct copy in hot path.
         out.key = e->key;
+        out.eval = e->eval;
         out.best = e->best;
         out.score = e->score;
         out.depth = e->depth;
@@ -114,15 +134,26 @@ struct SharedTT {
         return true;
     }
 
-    // Locked store; replace on key mismatch or when depth is at least as deep.
-    inline void store(uint64_t key, Move best, int16_t score, int16_t depth, uint8_t flag) {
+    // Static eval recorded for key, or TT_EVAL_NONE.
+    inline int probe_eval(uint64_t key) {
+        const TTEntry* e = tt.probe(key);
+        return (e->key == TT::verify_key(key)) ? e->eval : TT_EVAL_NONE;
+    }
+
+    inline void prefetch(uint64_t key) const { tt.prefetch(key); }
+
+    // Locked store; replace on key mismatch or when depth is at least as deep. A known
+    // static eval survives updates of the same position that do not carry one.
+    inline void store(uint64_t key, Move best, int16_t score, int16_t depth, uint8_t flag,
+                      int16_t eval = TT_EVAL_NONE) {
         std::lock_guard<std::mutex> g(locks[lock_index(key)]);
         TTEntry* e = tt.probe(key);
-        if (!e)
-            return;
-
-        if (e->key != key || depth >= e->depth) {
-            e->key = key;
+        const uint32_t k = TT::verify_key(key);
+        if (e->key != k || depth >= e->depth) {
+            if (e->key == k && eval == TT_EVAL_NONE)
+                eval = e->eval;
+            e->key = k;
+            e->eval = eval;
             e->best = best;
             e->score = score;
             e->depth = (depth > 127 ? 127 : (depth < -128 ? -128 : depth));
@@ -130,21 +161,84 @@ struct SharedTT {
         }
     }
 
-    inline void resize_mb(int mb) { tt.resize_mb(mb); }
-    inline void clear() {
-        for (auto& e : tt.table)
-            e = TTEntry{};
+    // Record a static eval: into the position's own entry, or as an eval-only entry
+    // (depth -1) in a slot that holds no search result, which any search store replaces.
+    // Runs on every qsearch eval miss, so it never waits: when the slot's lock is busy the
+    // eval is simply not recorded.
+    inline void store_eval(uint64_t key, int eval) {
+        std::unique_lock<std::mutex> g(locks[lock_index(key)], std::try_to_lock);
+        if (!g.owns_lock())
+            return;
+        TTEntry* e = tt.probe(key);
+        const uint32_t k = TT::verify_key(key);
+        const int16_t ev = (int16_t)std::clamp(eval, -32000, 32000);
+        if (e->key == k) {
+            e->eval = ev;
+        } else if (e->depth < 0) {
+            *e = TTEntry{};
+            e->key = k;
+            e->eval = ev;
+        }
     }
+
+    // Index with high key bits so busy slots do not alias TT buckets.
+    inline std::atomic<uint64_t>& busy_slot(uint64_t key) { return busy[(key >> 40) & (BUSY_SLOTS - 1)]; }
+    inline bool is_busy(uint64_t key) { return busy_slot(key).load(std::memory_order_relaxed) == key; }
+    inline void set_busy(uint64_t key) { busy_slot(key).store(key, std::memory_order_relaxed); }
+    inline void clear_busy(uint64_t key) {
+        uint64_t expected = key;
+        busy_slot(key).compare_exchange_strong(expected, 0, std::memory_order_relaxed);
+    }
+
+    // Zeroing runs in the background on `threads` threads, each pinned like the search
+    // thread of the same index, so a fresh table is first touched on (and interleaved over)
+    // their NUMA nodes. wait_clear() joins them before the table is searched or reallocated.
+    std::vector<std::thread> fillers;
+
+    inline void clear_async(int threads) {
+        if (!fillers.empty())
+            return; // nothing has searched since the pending clear started
+        const int n = (int)std::max<size_t>(1, std::min<size_t>(std::max(1, threads), tt.size() >> 16));
+        fillers.reserve(n);
+        for (int i = 0; i < n; i++) {
+            fillers.emplace_back([this, i, n]() {
+                bind_this_thread(i);
+                tt.clear_range(tt.size() * i / n, tt.size() * (i + 1) / n);
+            });
+        }
+    }
+
+    inline void wait_clear() {
+        for (auto& th : fillers)
+            th.join();
+        fillers.clear();
+    }
+
+    inline void resize_mb(int mb, int threads) {
+        wait_clear();
+        tt.resize_mb(mb);
+        clear_async(threads);
+    }
+
     inline int hashfull_permille() const { return hashfull_permille_fallback(tt); }
 };
 
+struct Searcher;
+
+// Lazy SMP pool; declared ahead of Searcher so the main thread can sum helper node counts.
+inline std::vector<Searcher*> g_pool;
+inline uint64_t nodes_searched();
+
+// Set once the YBWC master finishes, releasing helpers from their idle loop.
+alignas(CACHE_LINE_SIZE) inline std::atomic<bool> g_ybwc_exit{false};
+
 // Per-thread searcher state (history, killers, node counters).
-struct alignas(64) Searcher {
+struct alignas(CACHE_LINE_SIZE) Searcher {
     SharedTT* stt = nullptr;
     bool isMainSearchThread = false;
+    bool abdada = false; // defer children other threads are searching (SMP_ABDADA)
+    bool ybwc = false;   // share moves with idle pool threads at split points (SMP_YBWC)
     int threadIndex = 0;
-    int rootSplitOffset = 0;
-    int rootSplitStride = 1;
     static constexpr int MAX_PLY = 512;
     static constexpr int KEY_STACK_MAX = 1024;
 
@@ -152,81 +246,40 @@ struct alignas(64) Searcher {
     int history[2][64][64]{};
 
     Move countermove[64][64]{};
+    int captureHistory[16][64][8]{}; // [moved piece][to][captured type]
     int contHist[2][64][64][64][64]{};
 
-    uint64_t nodes = 0;
+    EvalCache evalCache;
+    eval::PawnTable pawnTable;
+    eval::MaterialTable materialTable;
+
+    NodeCounter nodes;
 
     PruneStats ps;
     SearchStats ss;
 
-    // Batch node counting to reduce atomic contention.
-    uint64_t nodes_batch = 0;
-    static constexpr uint64_t NODE_BATCH = 4096; // power of two
-    static constexpr uint64_t NODE_BATCH_WORKER = 16384;
-    uint32_t time_check_tick = 0;
-    static constexpr uint32_t TIME_CHECK_MASK_NODE = 4095; // every 4096 probes
-    static constexpr uint32_t TIME_CHECK_MASK_ROOT = 255;  // every 256 probes
-
-    inline void batch_time_check_soft() {
-        if (!isMainSearchThread)
-            return;
-        int64_t end = g_endTimeMs.load(std::memory_order_relaxed);
-        if (end == 0)
-            return;
-        if (now_ms() >= end)
-            g_stop.store(true, std::memory_order_relaxed);
-    }
-
-    inline void flush_nodes_batch() {
-        if (nodes_batch) {
-            g_nodes_total.fetch_add(nodes_batch, std::memory_order_relaxed);
-            nodes_batch = 0;
-        }
+    // Deadlines are enforced by g_timer, so the hot path only reads the stop flag and,
+    // inside a YBWC split, whether a split point above has been cut off.
+    inline bool stop_or_time_up() const {
+        return g_stop.load(std::memory_order_relaxed) || (activeSplit && activeSplit->cut_off());
     }
 
-    // Cheap stop/time probe: always read stop flag, but read clock sparsely.
-    inline bool stop_or_time_up(bool rootNode) {
-        if (g_stop.load(std::memory_order_relaxed))
-            return true;
-        // Worker threads follow the main thread stop flag only to avoid extra
-        // clock probes on hot paths.
-        if (!isMainSearchThread)
-            return false;
-        int64_t end = g_endTimeMs.load(std::memory_order_relaxed);
-        if (end == 0)
-            return false;
-
-        const uint32_t mask = rootNode ? TIME_CHECK_MASK_ROOT : TIME_CHECK_MASK_NODE;
-        if ((time_check_tick++ & mask) != 0)
-            return false;
-
-        if (collect_stats())
-            ss.timeChecks++;
-
-        if (now_ms() >= end) {
-            if (isMainSearchThread)
-                g_stop.store(true, std::memory_order_relaxed);
-            return true;
-        }
-        return false;
+    inline void add_node() { nodes.inc(); }
+
+    template <bool Stats>
+    inline int static_eval(const Position& pos) {
+        if constexpr (Stats)
+            return eval::evaluate(pos, pawnTable, materialTable, [this](bool hit) {
+                ss.pawnProbe++;
+                ss.pawnHit += hit;
+            });
+        else
+            return eval::evaluate(pos, pawnTable, materialTable);
     }
 
-    // Count a node and periodically publish to the global counter.
-    inline void add_node() {
-        nodes++;
-
-        nodes_batch++;
-
-        const uint64_t batchLimit = isMainSearchThread ? NODE_BATCH : NODE_BATCH_WORKER;
-        if (nodes_batch >= batchLimit) {
-            g_nodes_total.fetch_add(nodes_batch, std::memory_order_relaxed);
-            nodes_batch = 0;
-            batch_time_check_soft();
-        }
-    }
-
-    inline Undo do_move_counted(Position& pos, Move m, bool inQ, bool csOn) {
-        if (csOn) {
+    template <bool Stats>
+    inline Undo do_move_counted(Position& pos, Move m, bool inQ = false) {
+        if constexpr (Stats) {
             ss.makeCalls++;
             if (inQ)
                 ss.makeQ++;
@@ -236,27 +289,27 @@ struct alignas(64) Searcher {
         return pos.do_move(m);
     }
 
-    inline Undo do_move_counted(Position& pos, Move m, bool inQ = false) {
-        return do_move_counted(pos, m, inQ, collect_stats());
-    }
-
+    template <bool Stats>
     inline int see_quick_main(const Position& pos, Move m) {
-        if (collect_stats())
+        if constexpr (Stats)
             ss.seeCallsMain++;
         return see_quick(pos, m);
     }
+    template <bool Stats>
     inline int see_full_main(const Position& pos, Move m) {
-        if (collect_stats())
+        if constexpr (Stats)
             ss.seeCallsMain++;
         return see_full(pos, m);
     }
+    template <bool Stats>
     inline int see_quick_q(const Position& pos, Move m) {
-        if (collect_stats())
+        if constexpr (Stats)
             ss.seeCallsQ++;
         return see_quick(pos, m);
     }
+    template <bool Stats>
     inline int see_full_q(const Position& pos, Move m) {
-        if (collect_stats())
+        if constexpr (Stats)
             ss.seeCallsQ++;
         return see_full(pos, m);
     }
@@ -308,13 +361,14 @@ struct alignas(64) Searcher {
         return pinned;
     }
 
+    template <bool Stats>
     inline uint64_t pinned_mask_for_ply(const Position& pos, Color us, int plyCtx) {
         if ((unsigned)plyCtx >= (unsigned)MAX_PLY)
             return compute_pinned_mask_for_side(pos, us);
         if (!pinnedMaskValid[plyCtx]) {
             pinnedMaskCache[plyCtx] = compute_pinned_mask_for_side(pos, us);
             pinnedMaskValid[plyCtx] = true;
-            if (collect_stats())
+            if constexpr (Stats)
                 ss.pinCalc++;
         }
         return pinnedMaskCache[plyCtx];
@@ -322,13 +376,16 @@ struct alignas(64) Searcher {
 
     // Strictly safe SEE fast-path: if captured square has no enemy attackers after move,
     // exchange cannot continue, so SEE is non-negative for non-promo captures.
+    template <bool Stats>
     inline bool see_fast_non_negative(Position& pos, Move m, bool inQ = false) {
         const int to = to_sq(m);
-        Undo u = do_move_counted(pos, m, inQ);
+        Undo u = do_move_counted<Stats>(pos, m, inQ);
         const bool safe = !attacks::is_square_attacked(pos, to, pos.side);
         pos.undo_move(m, u);
-        if (safe && collect_stats())
-            ss.seeFastSafe++;
+        if constexpr (Stats) {
+            if (safe)
+                ss.seeFastSafe++;
+        }
         return safe;
     }
 
@@ -337,6 +394,87 @@ struct alignas(64) Searcher {
         int len = 0;
     };
 
+    // Only PV frames own PV storage. NonPV frames and their children share nullPV, which
+    // zero-window nodes only ever truncate, so its len stays 0.
+    struct NoPVLine {};
+    template <bool PvNode>
+    using PVBuffer = std::conditional_t<PvNode, PVLine, NoPVLine>;
+    PVLine nullPV;
+
+    inline PVLine& pv_buffer(PVLine& own) { return own; }
+    inline PVLine& pv_buffer(NoPVLine&) { return nullPV; }
+
+    // Root move state kept across iterations of one search. Moves that did not beat alpha
+    // hold score -INF; an aspiration fail low or high leaves a bound, flagged in bound.
+    struct RootMove {
+        Move move = 0;
+        int score = -INF;
+        uint8_t bound = TT_EXACT; // TT_ALPHA: upper bound, TT_BETA: lower bound
+        int prevScore = -INF;
+        int avgScore = -INF; // running average of the exact scores
+        uint64_t nodes = 0;  // nodes spent under this move during the whole search
+        int orderScore = 0;  // move-ordering score used to rank moves without an exact score
+        PVLine pv;           // line behind score
+    };
+
+    // YBWC split point, owned by the stack frame of the node that split. The remaining
+    // moves are handed out one at a time; alpha, the best line and the cutoff flag are
+    // shared under mtx. A cutoff here or at any ancestor split ends the work below it.
+    // The owner's search context (key history, depth) is snapshotted before any helper
+    // joins and never changes afterwards.
+    struct SplitPoint {
+        std::mutex mtx;
+        SplitPoint* parent = nullptr;
+        Searcher* owner = nullptr;
+        int keyPly = 0;
+        int rootDepth = 0;
+        int keyBase = 0;            // keyStack index of keys[0]
+        std::vector<uint64_t> keys; // keyStack[keyBase .. keyPly + ply], all repetitions can reach
+        Position pos;
+        attacks::CheckInfo ci;
+        Move moves[256]{};
+        int moveCount = 0;
+        int next = 0;
+        int depth = 0;
+        int beta = 0;
+        int ply = 0;
+        bool pvNode = false;
+        int alpha = 0;
+        int bestScore = -INF;
+        Move bestMove = 0;
+        PVLine bestChild;
+        std::atomic<bool> cutoff{false};
+        std::atomic<int> helpers{0}; // joined threads that have not left yet
+
+        inline bool cut_off() const {
+            for (const SplitPoint* sp = this; sp; sp = sp->parent) {
+                if (sp->cutoff.load(std::memory_order_relaxed))
+                    return true;
+            }
+            return false;
+        }
+    };
+
+    SplitPoint* activeSplit = nullptr;           // innermost split this thread works under
+    std::atomic<SplitPoint*> splitTask{nullptr}; // split handed to this thread while idle
+    // Where this thread may be recruited: nullptr when busy, any_split() when parked in
+    // ybwc_idle_loop, or the split a waiting owner helps below (helpful master).
+    std::atomic<SplitPoint*> idleAt{nullptr};
+    std::mutex splitMtx; // with splitCv, parks the thread until a task arrives
+    std::condition_variable splitCv;
+
+    static SplitPoint* any_split() {
+        static SplitPoint anywhere;
+        return &anywhere;
+    }
+
+    // Wake this thread if it is parked on splitCv; the lock orders the wakeup after the
+    // caller's store, so it cannot be lost.
+    inline void wake_split() {
+        { std::lock_guard<std::mutex> lk(splitMtx); }
+        splitCv.notify_one();
+    }
+
     Searcher() {
         for (int i = 0; i < MAX_PLY; i++) {
             plyMoves[i].reserve(256);
@@ -349,15 +487,12 @@ struct alignas(64) Searcher {
 
     inline void bind(SharedTT* shared) { stt = shared; }
     inline void set_thread_index(int idx) { threadIndex = std::max(0, idx); }
-    inline void set_root_split(int offset, int stride) {
-        rootSplitOffset = std::max(0, offset);
-        rootSplitStride = std::max(1, stride);
-    }
 
     inline uint64_t key_of(const Position& pos) const { return pos.zobKey; }
 
     uint64_t keyStack[KEY_STACK_MAX]{};
     int keyPly = 0;
+    int rootDepth = 0; // current iterative-deepening depth
     int staticEvalStack[MAX_PLY]{};
     uint64_t pinnedMaskCache[MAX_PLY]{};
     bool pinnedMaskValid[MAX_PLY]{};
@@ -365,6 +500,7 @@ struct alignas(64) Searcher {
     bool inCheckCache[MAX_PLY]{};
     bool inCheckCacheValid[MAX_PLY]{};
 
+    std::vector<RootMove> rootMoves; // ordered by think() between iterations
     std::vector<Move> plyMoves[MAX_PLY];
     std::vector<int> plyScores[MAX_PLY];
     std::vector<int> plyOrder[MAX_PLY];
@@ -503,24 +639,43 @@ struct alignas(64) Searcher {
 
     #include "search/SearcherPVUtils.inl"
 
+    #include "search/SearcherDraws.inl"
+
     #include "search/SearcherNegamax.inl"
 
+    #include "search/SearcherSplit.inl"
+
     #include "search/SearcherThink.inl"
 };
 
+// Parallel search algorithm used when more than one thread searches.
+enum SmpMode { SMP_LAZY = 0, SMP_ABDADA = 1, SMP_YBWC = 2 };
+
 // Thread pool / Lazy SMP globals.
 inline std::atomic<int> g_threads{1};
+inline std::atomic<int> g_smp_mode{SMP_LAZY};
 inline int g_hash_mb = 64;
 
 inline std::unique_ptr<SharedTT> g_shared_tt;
 
 inline std::vector<std::unique_ptr<Searcher>> g_pool_owner;
-inline std::vector<Searcher*> g_pool;
+
+// Total nodes across the pool; counters of threads idle in this search hold zero.
+inline uint64_t nodes_searched() {
+    uint64_t total = 0;
+    for (const Searcher* s : g_pool)
+        total += s->nodes.get();
+    return total;
+}
 
 inline int threads() {
     return g_threads.load(std::memory_order_relaxed);
 }
 
+inline void set_smp_mode(SmpMode m) {
+    g_smp_mode.store(m, std::memory_order_relaxed);
+}
+
 // Lazy SMP scales poorly on very short limits due to duplicated work and TT
 // contention. Use fewer effective threads for short searches to preserve depth.
 inline int effective_threads_for_limits(const Limits& lim, int requested) {
@@ -544,21 +699,40 @@ inline int effective_threads_for_limits(const Limits& lim, int requested) {
     return n;
 }
 
+// Each Searcher is constructed, and so first touched, by a thread pinned to the core its
+// search thread will run on, which keeps the per-thread tables on that thread's NUMA node.
+inline void build_pool(int n) {
+    g_pool_owner.clear();
+    g_pool_owner.resize(n);
+    g_pool.clear();
+    g_pool.reserve(n);
+
+    std::vector<std::thread> builders;
+    builders.reserve(n);
+    for (int i = 0; i < n; i++) {
+        builders.emplace_back([i]() {
+            bind_this_thread(i);
+            g_pool_owner[i] = std::make_unique<Searcher>();
+        });
+    }
+    for (auto& th : builders)
+        th.join();
+
+    for (int i = 0; i < n; i++) {
+        g_pool_owner[i]->bind(g_shared_tt.get());
+        g_pool_owner[i]->set_thread_index(i);
+        g_pool.push_back(g_pool_owner[i].get());
+    }
+}
+
 inline void ensure_pool() {
     if (!g_shared_tt) {
         g_shared_tt = std::make_unique<SharedTT>();
-        g_shared_tt->resize_mb(std::max(1, g_hash_mb));
+        g_shared_tt->resize_mb(std::max(1, g_hash_mb), threads());
     }
 
     if (g_pool.empty()) {
-        g_pool_owner.clear();
-        g_pool.clear();
-
-        g_pool_owner.emplace_back(std::make_unique<Searcher>());
-        g_pool_owner.back()->bind(g_shared_tt.get());
-        g_pool_owner.back()->set_thread_index(0);
-        g_pool.push_back(g_pool_owner.back().get());
-
+        build_pool(1);
         g_threads.store(1, std::memory_order_relaxed);
     }
 }
@@ -568,66 +742,178 @@ inline void set_threads(int n) {
 
     n = std::max(1, std::min(256, n));
     g_threads.store(n, std::memory_order_relaxed);
+    build_pool(n);
+}
 
-    g_pool_owner.clear();
-    g_pool_owner.reserve(n);
-    g_pool.clear();
-    g_pool.reserve(n);
+// Toggling affinity rebuilds the pool so per-thread state moves to the new placement.
+inline void set_thread_affinity(bool on) {
+    if (g_bind_threads.exchange(on, std::memory_order_relaxed) != on && !g_pool.empty())
+        build_pool((int)g_pool.size());
+}
 
-    for (int i = 0; i < n; i++) {
-        g_pool_owner.emplace_back(std::make_unique<Searcher>());
-        g_pool_owner.back()->bind(g_shared_tt.get());
-        g_pool_owner.back()->set_thread_index(i);
-        g_pool.push_back(g_pool_owner.back().get());
+// Joins a pending background TT clear; callers arming the clock themselves run it first.
+inline void wait_tt_clear() {
+    ensure_pool();
+    g_shared_tt->wait_clear();
+}
+
+// Lazy SMP vote: every thread backs its move with (score - worst score + 14) * depth,
+// and the best-scoring thread among those playing the winning move is returned.
+inline int pick_best_thread(const std::vector<Result>& results) {
+    int minScore = INF;
+    for (const Result& r : results) {
+        if (r.bestMove && r.depth > 0)
+            minScore = std::min(minScore, r.score);
     }
+
+    std::vector<std::pair<Move, int64_t>> votes;
+    auto vote_of = [&](Move m) -> int64_t& {
+        for (auto& v : votes) {
+            if (v.first == m)
+                return v.second;
+        }
+        votes.emplace_back(m, 0);
+        return votes.back().second;
+    };
+    for (const Result& r : results) {
+        if (r.bestMove && r.depth > 0)
+            vote_of(r.bestMove) += int64_t(r.score - minScore + 14) * r.depth;
+    }
+
+    int best = 0;
+    for (int i = 1; i < (int)results.size(); i++) {
+        const Result& r = results[i];
+        const Result& b = results[best];
+        if (!r.bestMove || r.depth == 0)
+            continue;
+        if (!b.bestMove || b.depth == 0) {
+            best = i;
+            continue;
+        }
+        // A mate score beats the vote; the shortest mate wins.
+        if (r.score >= MATE_BOUND || b.score >= MATE_BOUND) {
+            if (r.score > b.score)
+                best = i;
+            continue;
+        }
+        const int64_t vr = vote_of(r.bestMove), vb = vote_of(b.bestMove);
+        if (vr > vb || (vr == vb && r.score > b.score))
+            best = i;
+    }
+    return best;
+}
+
+// Final info line for a helper's result chosen by the vote, whose line the GUI has not
+// seen: bestmove and ponder must agree with the last reported pv.
+inline void print_result_info(const Result& r) {
+    const int64_t t = std::max<int64_t>(1, now_ms() - g_searchStartMs.load(std::memory_order_relaxed));
+    const uint64_t n = nodes_searched();
+    std::cout << "info depth " << r.depth << " multipv 1 ";
+    print_score_uci(r.score);
+    std::cout << " nodes " << n << " nps " << (n * 1000ULL) / (uint64_t)t << " time " << t << " pv";
+    for (Move m : r.pv)
+        std::cout << " " << move_to_uci(m);
+    std::cout << std::endl;
 }
 
-// Public search API (single-thread or Lazy SMP).
-inline Result think(Position& pos, const Limits& lim) {
+// Single-thread, Lazy SMP, ABDADA or YBWC search, instantiated with and without SearchStats instrumentation.
+template <bool Stats>
+inline Result think_impl(Position& pos, const Limits& lim, const std::vector<uint64_t>& gameKeys) {
     ensure_pool();
 
-    g_nodes_total.store(0, std::memory_order_relaxed);
-    start_timer(lim.movetime_ms, lim.infinite, lim.optimum_ms);
+    for (Searcher* s : g_pool)
+        s->nodes.reset();
+    // A clear started by ucinewgame or a Hash change overlaps the idle time until here;
+    // it finishes before the clock starts, so it never eats into the move's time.
+    wait_tt_clear();
+    if (!lim.ponder)
+        start_timer(lim.movetime_ms, lim.infinite, lim.optimum_ms);
 
     const int requestedThreads = threads();
     const int n = effective_threads_for_limits(lim, requestedThreads);
+    const int mode = g_smp_mode.load(std::memory_order_relaxed);
+    // The caller runs searcher 0 and gets its own affinity back when the search returns.
+    const ScopedThreadBinding binding(0);
+    for (int i = 0; i < n; i++) {
+        g_pool[i]->abdada = (n > 1 && mode == SMP_ABDADA);
+        g_pool[i]->ybwc = (n > 1 && mode == SMP_YBWC);
+    }
+
     if (n <= 1) {
-        Result r = g_pool[0]->think(pos, lim, true);
-        r.nodes = g_nodes_total.load(std::memory_order_relaxed);
+        Result r = g_pool[0]->think<Stats>(pos, lim, true, gameKeys);
+        r.nodes = nodes_searched();
         return r;
     }
 
     std::vector<std::thread> workers;
     workers.reserve(n - 1);
 
-    // Worker threads search independent copies of the root position.
-    // Split root move space across workers to reduce duplicated root work.
+    // YBWC: one iterative-deepening search; helpers only ever work inside its split points.
+    if (mode == SMP_YBWC) {
+        g_ybwc_exit.store(false, std::memory_order_relaxed);
+        for (int i = 1; i < n; i++)
+            workers.emplace_back([i]() {
+                bind_this_thread(i);
+                g_pool[i]->ybwc_idle_loop<Stats>();
+            });
+
+        Result r = g_pool[0]->think<Stats>(pos, lim, true, gameKeys);
+
+        stop();
+        g_ybwc_exit.store(true, std::memory_order_release);
+        for (int i = 1; i < n; i++)
+            g_pool[i]->wake_split();
+        for (auto& th : workers)
+            th.join();
+        r.nodes = nodes_searched();
+        return r;
+    }
+
+    std::vector<Result> results(n);
+
+    // Helpers search independent copies of the root position over all root moves,
+    // staggered across depths by their skip pattern.
     for (int i = 1; i < n; i++) {
-        g_pool[i]->set_root_split(i - 1, n - 1);
         Position pcopy = pos;
-        workers.emplace_back([i, pcopy, lim]() mutable { g_pool[i]->think(pcopy, lim, false); });
+        workers.emplace_back([i, pcopy, lim, &gameKeys, &results]() mutable {
+            bind_this_thread(i);
+            results[i] = g_pool[i]->think<Stats>(pcopy, lim, false, gameKeys);
+        });
     }
 
-    g_pool[0]->set_root_split(0, 1);
-    Result mainRes = g_pool[0]->think(pos, lim, true);
+    results[0] = g_pool[0]->think<Stats>(pos, lim, true, gameKeys);
 
     stop();
     for (auto& th : workers)
         th.join();
 
-    mainRes.nodes = g_nodes_total.load(std::memory_order_relaxed);
-    return mainRes;
+    const int bestIdx = pick_best_thread(results);
+    Result best = results[bestIdx];
+    best.nodes = nodes_searched();
+    if (bestIdx != 0)
+        print_result_info(best);
+    return best;
+}
+
+// Public search API; the SearchStats option picks the instantiation once per search.
+inline Result think(Position& pos, const Limits& lim, const std::vector<uint64_t>& gameKeys = {}) {
+    return collect_stats() ? think_impl<true>(pos, lim, gameKeys) : think_impl<false>(pos, lim, gameKeys);
+}
+
+// Ponderhit: the running ponder search continues under lim's time budget from now on.
+inline void ponderhit(const Limits& lim) {
+    arm_deadlines(lim.movetime_ms, lim.infinite, lim.optimum_ms);
 }
 
 inline void set_hash_mb(int mb) {
     ensure_pool();
     g_hash_mb = std::max(1, mb);
-    g_shared_tt->resize_mb(g_hash_mb);
+    g_shared_tt->resize_mb(g_hash_mb, threads());
 }
 
 inline void clear_tt() {
     ensure_pool();
-    g_shared_tt->clear();
+    g_shared_tt->clear_async(threads());
 }
 
 } // namespace search
@@ -2,6 +2,8 @@
 #include <vector>
 #include <cstdint>
 #include <algorithm>
+#include <cstddef>
+#include <new>
 
 #include "types.h" // Move encoding.
 
@@ -10,11 +12,15 @@ namespace search {
 // Transposition table (single replacement bucket).
 enum TTFlag : uint8_t { TT_EXACT = 0, TT_ALPHA = 1, TT_BETA = 2 };
 
+// Static eval slot of an entry whose position has not been evaluated yet.
+inline constexpr int16_t TT_EVAL_NONE = INT16_MIN;
+
 struct alignas(16) TTEntry {
-    uint64_t key = 0;   // full zobrist key
-    Move best = 0;      // best move
-    int16_t score = 0;  // stored score (TT-adjusted)
-    int8_t depth = -1;  // search depth in plies
+    uint32_t key = 0;            // upper half of the zobrist key; the lower bits select the slot
+    int16_t eval = TT_EVAL_NONE; // static evaluation, shared with qsearch stand-pat
+    int16_t score = 0;           // stored score (TT-adjusted)
+    Move best = 0;               // best move
+    int8_t depth = -1;           // search depth in plies; -1 for eval-only entries
     uint8_t flag = TT_EXACT;
 };
 
@@ -22,32 +28,65 @@ struct alignas(16) TTEntry {
 static_assert(sizeof(TTEntry) == 16, "TTEntry size changed; review layout/alignment.");
 
 struct TT {
-    std::vector<TTEntry> table;
+    TTEntry* table = nullptr;
+    size_t entries = 0;
     uint64_t mask = 0;
 
     TTEntry dummy; // Returned when the table is empty.
 
+    TT() = default;
+    TT(const TT&) = delete;
+    TT& operator=(const TT&) = delete;
+    ~TT() { release(); }
+
+    // Allocates without touching the memory: the owner initialises it with clear_range()
+    // from the threads that will search, so first-touch spreads the pages over their NUMA nodes.
     void resize_mb(int mb) {
         size_t bytes = size_t(std::max(1, mb)) * 1024ULL * 1024ULL;
         size_t n = std::max<size_t>(1, bytes / sizeof(TTEntry));
         size_t p2 = 1;
         while (p2 < n)
             p2 <<= 1;
-        table.assign(p2, TTEntry{});
+        release();
+        table = static_cast<TTEntry*>(::operator new(p2 * sizeof(TTEntry), std::align_val_t{alignof(TTEntry)}));
+        entries = p2;
         mask = p2 - 1;
     }
 
+    inline bool empty() const { return entries == 0; }
+    inline size_t size() const { return entries; }
+
+    static inline uint32_t verify_key(uint64_t key_) { return uint32_t(key_ >> 32); }
+
     inline TTEntry* probe(uint64_t key_) {
-        if (table.empty())
+        if (!table)
             return &dummy;
         // Power-of-two size: index is fast mask.
         return &table[size_t(key_) & mask];
     }
 
-    inline void clear() {
-        if (!table.empty()) {
-            std::fill(table.begin(), table.end(), TTEntry{});
-        }
+    // Start pulling the entry for key_ into cache ahead of the probe.
+    inline void prefetch(uint64_t key_) const {
+#if defined(__GNUC__) || defined(__clang__)
+        if (table)
+            __builtin_prefetch(&table[size_t(key_) & mask]);
+#else
+        (void)key_;
+#endif
+    }
+
+    inline void clear_range(size_t begin, size_t end) {
+        std::fill(table + std::min(begin, entries), table + std::min(end, entries), TTEntry{});
+    }
+
+    inline void clear() { clear_range(0, entries); }
+
+    void release() {
+        if (table)
+            ::operator delete(table, std::align_val_t{alignof(TTEntry)});
+        table = nullptr;
+        entries = 0;
+        mask = 0;
     }
 };
 
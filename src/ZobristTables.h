@@ -1,6 +1,9 @@
 #pragma once
 #include <cstdint>
 #include <random>
+#include <utility>
+
+#include "types.h"
 
 // Zobrist tables only. Keep Position out to avoid include cycles.
 struct ZobristTables {
@@ -8,6 +11,7 @@ struct ZobristTables {
     uint64_t sideKey = 0;
     uint64_t castleKey[16]{};
     uint64_t epKey[8]{};
+    uint64_t matKey[16][16]{}; // [piece][index of that piece]: material signature keys
 
     ZobristTables() {
         // Fixed seed so keys are deterministic across runs.
@@ -23,7 +27,72 @@ struct ZobristTables {
             castleKey[i] = R();
         for (int i = 0; i < 8; i++)
             epKey[i] = R();
+        for (int p = 0; p < 16; p++)
+            for (int i = 0; i < 16; i++)
+                matKey[p][i] = R();
     }
 };
 
 inline ZobristTables g_zob;
+
+// Cuckoo table of reversible piece moves keyed by their Zobrist difference
+// (both piece squares plus side to move). Used to detect that the side to move
+// can reach an earlier position in one move (upcoming repetition).
+struct CuckooTables {
+    static constexpr int SIZE = 8192; // power of two
+    uint64_t keys[SIZE]{};
+    Move moves[SIZE]{};
+
+    static inline int h1(uint64_t key) { return int(key & (SIZE - 1)); }
+    static inline int h2(uint64_t key) { return int((key >> 16) & (SIZE - 1)); }
+
+    // Empty-board reachability for non-pawn pieces.
+    static bool reaches(int pt, int s1, int s2) {
+        const int df = (s2 & 7) - (s1 & 7);
+        const int dr = (s2 >> 3) - (s1 >> 3);
+        const int af = df < 0 ? -df : df;
+        const int ar = dr < 0 ? -dr : dr;
+        const bool diag = (af == ar && af != 0);
+        const bool line = ((af == 0) != (ar == 0));
+        switch (pt) {
+        case KNIGHT:
+            return (af == 1 && ar == 2) || (af == 2 && ar == 1);
+        case BISHOP:
+            return diag;
+        case ROOK:
+            return line;
+        case QUEEN:
+            return diag || line;
+        case KING:
+            return (af | ar) != 0 && af <= 1 && ar <= 1;
+        default:
+            return false;
+        }
+    }
+
+    explicit CuckooTables(const ZobristTables& z) {
+        for (int c = 0; c < 2; c++) {
+            for (int pt = KNIGHT; pt <= KING; pt++) {
+                const int pc = (c == 0) ? pt : pt + 8;
+                for (int s1 = 0; s1 < 64; s1++) {
+                    for (int s2 = s1 + 1; s2 < 64; s2++) {
+                        if (!reaches(pt, s1, s2))
+                            continue;
+                        Move move = make_move(s1, s2);
+                        uint64_t key = z.psq[pc][s1] ^ z.psq[pc][s2] ^ z.sideKey;
+                        int i = h1(key);
+                        while (true) {
+                            std::swap(keys[i], key);
+                            std::swap(moves[i], move);
+                            if (move == 0)
+                                break;
+                            i = (i == h1(key)) ? h2(key) : h1(key);
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+inline CuckooTables g_cuckoo{g_zob};
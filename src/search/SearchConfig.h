@@ -2,12 +2,12 @@
 
 namespace search {
 
-struct SearchConfig {
-    int rootOrderK = 16;
-};
-
-inline SearchConfig g_params{};
 inline constexpr int INF = 32000;
 inline constexpr int MATE = 30000;
+// Scores beyond this bound encode a forced mate (distance in plies from MATE).
+inline constexpr int MATE_BOUND = MATE - 1024;
+
+// Node type the main search is instantiated on.
+enum NodeType { NonPV, PV, Root };
 
 } // namespace search
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace search {
+
+// Direct-mapped cache of static evaluations owned by one search thread. Qsearch leaves
+// recur across iterations and sibling subtrees but rarely keep a TT slot of their own.
+struct EvalCache {
+    static constexpr size_t SIZE = 1u << 16; // entries, power of two
+
+    struct Entry {
+        uint32_t key = 0; // upper half of the zobrist key; the lower bits select the slot
+        int32_t eval = 0;
+    };
+
+    Entry table[SIZE]{};
+
+    inline bool probe(uint64_t key, int& eval) const {
+        const Entry& e = table[size_t(key) & (SIZE - 1)];
+        if (e.key != uint32_t(key >> 32))
+            return false;
+        eval = e.eval;
+        return true;
+    }
+
+    inline void store(uint64_t key, int eval) {
+        Entry& e = table[size_t(key) & (SIZE - 1)];
+        e.key = uint32_t(key >> 32);
+        e.eval = eval;
+    }
+};
+
+} // namespace search
@@ -33,13 +33,13 @@ inline std::string move_to_uci(Move m) {
 }
 
 inline void print_score_uci(int score) {
-    if (score >= MATE - 1024) {
+    if (score >= MATE_BOUND) {
         int plies = MATE - score;
         int mateIn = (plies + 1) / 2;
         std::cout << "score mate " << mateIn;
         return;
     }
-    if (score <= -MATE + 1024) {
+    if (score <= -MATE_BOUND) {
         int plies = MATE + score;
         int mateIn = (plies + 1) / 2;
         std::cout << "score mate -" << mateIn;
@@ -48,4 +48,4 @@ inline void print_score_uci(int score) {
     std::cout << "score cp " << score;
 }
 
-} // namespace search
+} // namespace search
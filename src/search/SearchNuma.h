@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace search {
+
+// Optional CPU affinity for search threads (UCI "Thread Affinity"). Off by default.
+inline std::atomic<bool> g_bind_threads{false};
+
+// Parses a sysfs cpu list such as "0-3,8,10-11".
+inline std::vector<int> parse_cpu_list(const std::string& s) {
+    std::vector<int> cpus;
+    std::stringstream ss(s);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        if (part.empty() || part[0] < '0' || part[0] > '9')
+            continue;
+        const size_t dash = part.find('-');
+        const int lo = std::stoi(part.substr(0, dash));
+        const int hi = (dash == std::string::npos) ? lo : std::stoi(part.substr(dash + 1));
+        for (int c = lo; c <= hi; c++)
+            cpus.push_back(c);
+    }
+    return cpus;
+}
+
+inline std::string read_sysfs_line(const std::string& path) {
+    std::ifstream f(path);
+    std::string line;
+    if (f)
+        std::getline(f, line);
+    return line;
+}
+
+// One cpu set per physical core (its hyperthread siblings), ordered so that consecutive
+// entries alternate between NUMA nodes. Discovered from sysfs once; empty when unknown.
+inline std::vector<std::vector<int>> discover_core_sets() {
+    std::vector<std::pair<int, std::vector<int>>> nodes;
+    std::error_code ec;
+    for (const auto& e : std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+        const std::string name = e.path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 || !std::isdigit((unsigned char)name[4]))
+            continue;
+        std::vector<int> cpus = parse_cpu_list(read_sysfs_line((e.path() / "cpulist").string()));
+        if (!cpus.empty())
+            nodes.emplace_back(std::atoi(name.c_str() + 4), std::move(cpus));
+    }
+    std::sort(nodes.begin(), nodes.end());
+
+    std::vector<std::vector<int>> nodeCpus;
+    for (auto& n : nodes)
+        nodeCpus.push_back(std::move(n.second));
+    if (nodeCpus.empty()) {
+        std::vector<int> online = parse_cpu_list(read_sysfs_line("/sys/devices/system/cpu/online"));
+        if (online.empty())
+            return {};
+        nodeCpus.push_back(std::move(online));
+    }
+
+    // Per node, keep each core once: the cpu that comes first among its siblings.
+    std::vector<std::vector<std::vector<int>>> nodeCores(nodeCpus.size());
+    for (size_t n = 0; n < nodeCpus.size(); n++) {
+        for (int cpu : nodeCpus[n]) {
+            std::vector<int> siblings = parse_cpu_list(read_sysfs_line(
+                "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list"));
+            if (siblings.empty())
+                siblings.push_back(cpu);
+            if (*std::min_element(siblings.begin(), siblings.end()) == cpu)
+                nodeCores[n].push_back(std::move(siblings));
+        }
+    }
+
+    std::vector<std::vector<int>> cores;
+    for (size_t i = 0;; i++) {
+        bool any = false;
+        for (const auto& nc : nodeCores) {
+            if (i < nc.size()) {
+                cores.push_back(nc[i]);
+                any = true;
+            }
+        }
+        if (!any)
+            break;
+    }
+    return cores;
+}
+
+inline const std::vector<std::vector<int>>& core_sets() {
+    static const std::vector<std::vector<int>> cores = discover_core_sets();
+    return cores;
+}
+
+#if defined(__linux__)
+// The process's affinity at startup: all online cpus unless the engine was started
+// restricted (taskset, cgroups). Unpinned threads get this mask back.
+inline const cpu_set_t g_process_affinity = []() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            CPU_SET(cpu, &set);
+    }
+    return set;
+}();
+
+// Set once any thread has been pinned; until then unpinned threads need no reset.
+inline std::atomic<bool> g_threads_were_bound{false};
+#endif
+
+// Pins the calling thread to the core of search thread idx when affinity is enabled.
+// Threads beyond the core count wrap around; failures leave the thread unpinned. With
+// affinity off, a thread that may have inherited a pinned mask gets the process mask back.
+inline void bind_this_thread(int idx) {
+#if defined(__linux__)
+    if (!g_bind_threads.load(std::memory_order_relaxed)) {
+        if (g_threads_were_bound.load(std::memory_order_relaxed))
+            sched_setaffinity(0, sizeof(g_process_affinity), &g_process_affinity);
+        return;
+    }
+    const auto& cores = core_sets();
+    if (cores.empty())
+        return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cores[size_t(std::max(0, idx)) % cores.size()]) {
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &set);
+    }
+    g_threads_were_bound.store(true, std::memory_order_relaxed);
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)idx;
+#endif
+}
+
+// Binds a thread that does not belong to the engine (the UCI thread running a search)
+// for one scope, and gives it back its own mask afterwards, so threads it creates
+// later do not inherit the pinned mask.
+class ScopedThreadBinding {
+  public:
+    explicit ScopedThreadBinding(int idx) {
+#if defined(__linux__)
+        if (!g_bind_threads.load(std::memory_order_relaxed))
+            return;
+        saved_ = sched_getaffinity(0, sizeof(mask_), &mask_) == 0;
+#endif
+        bind_this_thread(idx);
+    }
+    ~ScopedThreadBinding() {
+#if defined(__linux__)
+        if (saved_)
+            sched_setaffinity(0, sizeof(mask_), &mask_);
+#endif
+    }
+    ScopedThreadBinding(const ScopedThreadBinding&) = delete;
+    ScopedThreadBinding& operator=(const ScopedThreadBinding&) = delete;
+
+  private:
+#if defined(__linux__)
+    cpu_set_t mask_;
+    bool saved_ = false;
+#endif
+};
+
+} // namespace search
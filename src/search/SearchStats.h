@@ -31,7 +31,6 @@ struct PruneStats {
 struct SearchStats {
     static constexpr int BUCKET_N = 5;
 
-    uint64_t timeChecks = 0;
     uint64_t makeCalls = 0;
     uint64_t makeMain = 0;
     uint64_t makeQ = 0;
@@ -54,6 +53,12 @@ struct SearchStats {
     uint64_t ttMoveAvail = 0;
     uint64_t ttMoveFirst = 0;
 
+    uint64_t evalProbe = 0;    // qsearch stand-pat lookups
+    uint64_t evalCacheHit = 0; // served by the thread's eval cache
+    uint64_t evalTTHit = 0;    // served by the TT eval field
+    uint64_t pawnProbe = 0;    // pawn hash lookups by static evaluation
+    uint64_t pawnHit = 0;
+
     uint64_t lmrTried = 0;
     uint64_t lmrResearched = 0;
     uint64_t lmrReducedByBucket[4]{};
@@ -91,6 +96,7 @@ struct SearchStats {
     void clear() { *this = SearchStats{}; }
 };
 
+// SearchStats UCI option; read once per search to pick the instrumented instantiation.
 inline std::atomic<bool> g_collect_stats{false};
 
 inline bool collect_stats() {
@@ -101,4 +107,4 @@ inline void set_collect_stats(bool on) {
     g_collect_stats.store(on, std::memory_order_relaxed);
 }
 
-} // namespace search
+} // namespace search
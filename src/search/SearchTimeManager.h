@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace search {
+
+// Per-move time budget in clock mode: the search aims for optimum_ms (the soft
+// limit, rescaled while searching) and never exceeds maximum_ms (the hard limit).
+struct TimeBudget {
+    int optimum_ms = 0;
+    int maximum_ms = 0;
+};
+
+inline TimeBudget compute_time_budget(int time_ms, int inc_ms, int movestogo, int overhead_ms) {
+    TimeBudget b{};
+    const int tleft = std::max(1, time_ms - std::max(0, overhead_ms));
+    inc_ms = std::max(0, inc_ms);
+
+    // Near-flag: spend a small fixed share of what is left.
+    if (tleft <= 200) {
+        b.maximum_ms = std::max(1, tleft / 4);
+        b.optimum_ms = std::max(1, tleft / 8);
+        return b;
+    }
+
+    // Sudden death plans over a fixed horizon; repeating controls over the moves left.
+    const int mtg = (movestogo > 0) ? std::min(movestogo, 50) : 35;
+    const int64_t pool = (int64_t)tleft + (int64_t)inc_ms * (mtg - 1);
+    const int optimum = (int)std::max<int64_t>(1, pool / mtg);
+
+    const int hardCap = (mtg == 1) ? (tleft * 9) / 10 : (tleft * 3) / 4;
+    b.maximum_ms = std::max(1, std::min(optimum * 5, hardCap));
+    b.optimum_ms = std::max(1, std::min(optimum, b.maximum_ms));
+    return b;
+}
+
+// Soft-limit scale from search progress: a best move that stays put, a steady or
+// rising score, and most of the effort going to the best move all save time.
+inline double soft_time_scale(int stableIters, int scoreDrop, double bestMoveEffort) {
+    const double stability = 1.25 - 0.1 * std::min(stableIters, 6);
+    const double falling = 1.0 + std::clamp(scoreDrop, -20, 200) / 200.0;
+    const double effort = std::clamp(1.6 - bestMoveEffort, 0.7, 1.3);
+    return std::clamp(stability * falling * effort, 0.35, 2.5);
+}
+
+} // namespace search
@@ -2,40 +2,143 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
+#include <mutex>
+#include <thread>
 
 namespace search {
 
-inline std::atomic<bool> g_stop{false};
-inline std::atomic<int64_t> g_endTimeMs{0};
-inline std::atomic<int64_t> g_softTimeMs{0};
-inline std::atomic<uint64_t> g_nodes_total{0};
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Control flags polled by every search thread; each sits on its own cache line.
+alignas(CACHE_LINE_SIZE) inline std::atomic<bool> g_stop{false};
+alignas(CACHE_LINE_SIZE) inline std::atomic<int64_t> g_endTimeMs{0};
+alignas(CACHE_LINE_SIZE) inline std::atomic<int64_t> g_softTimeMs{0};
+alignas(CACHE_LINE_SIZE) inline std::atomic<bool> g_softExpired{false};
+
+// Clock-mode soft budget and the time it is counted from; 0 outside clock mode.
+// Both are rewritten when a ponder search turns into a timed one.
+alignas(CACHE_LINE_SIZE) inline std::atomic<int> g_optimumMs{0};
+alignas(CACHE_LINE_SIZE) inline std::atomic<int64_t> g_searchStartMs{0};
+
+// Node counter written only by its owning thread and read by the info/limit code.
+// A relaxed load+store avoids a locked add, and the padding keeps readers off the owner's hot lines.
+struct alignas(CACHE_LINE_SIZE) NodeCounter {
+    std::atomic<uint64_t> n{0};
+
+    inline uint64_t inc() {
+        const uint64_t v = n.load(std::memory_order_relaxed) + 1;
+        n.store(v, std::memory_order_relaxed);
+        return v;
+    }
+    inline uint64_t get() const { return n.load(std::memory_order_relaxed); }
+    inline void reset() { n.store(0, std::memory_order_relaxed); }
+};
 
 inline int64_t now_ms() {
     using namespace std::chrono;
     return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
 }
 
-inline void start_timer(int movetime_ms, bool infinite, int optimum_ms = 0) {
-    g_stop.store(false, std::memory_order_relaxed);
+// Deadline watcher: sleeps until the next soft or hard deadline and raises the
+// matching flag itself, so search threads never read the clock.
+class TimerService {
+  public:
+    ~TimerService() {
+        {
+            std::lock_guard<std::mutex> g(mtx_);
+            quit_ = true;
+        }
+        cv_.notify_one();
+        if (th_.joinable())
+            th_.join();
+    }
+
+    // Absolute steady-clock deadlines in ms; 0 disables that deadline.
+    void arm(int64_t hardMs, int64_t softMs) {
+        {
+            std::lock_guard<std::mutex> g(mtx_);
+            g_endTimeMs.store(hardMs, std::memory_order_relaxed);
+            g_softTimeMs.store(softMs, std::memory_order_relaxed);
+            g_softExpired.store(false, std::memory_order_relaxed);
+            if (!th_.joinable())
+                th_ = std::thread([this]() { run(); });
+        }
+        cv_.notify_one();
+    }
+
+    // Move the soft deadline while a search is running.
+    void set_soft(int64_t softMs) {
+        {
+            std::lock_guard<std::mutex> g(mtx_);
+            g_softTimeMs.store(softMs, std::memory_order_relaxed);
+            g_softExpired.store(softMs > 0 && now_ms() >= softMs, std::memory_order_relaxed);
+        }
+        cv_.notify_one();
+    }
+
+  private:
+    void run() {
+        using namespace std::chrono;
+        std::unique_lock<std::mutex> lk(mtx_);
+        while (!quit_) {
+            const int64_t hard = g_stop.load(std::memory_order_relaxed) ? 0 : g_endTimeMs.load(std::memory_order_relaxed);
+            const int64_t soft = g_softExpired.load(std::memory_order_relaxed) ? 0 : g_softTimeMs.load(std::memory_order_relaxed);
+            int64_t next = soft;
+            if (hard && (!next || hard < next))
+                next = hard;
+            if (!next) {
+                cv_.wait(lk);
+                continue;
+            }
+
+            const int64_t n = now_ms();
+            if (n < next) {
+                cv_.wait_until(lk, steady_clock::time_point(milliseconds(next)));
+                continue;
+            }
+            if (soft && n >= soft)
+                g_softExpired.store(true, std::memory_order_relaxed);
+            if (hard && n >= hard)
+                g_stop.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::thread th_;
+    bool quit_ = false;
+};
+
+inline TimerService g_timer;
+
+// Deadlines counted from now; leaves g_stop alone so a running search can be retimed.
+inline void arm_deadlines(int movetime_ms, bool infinite, int optimum_ms = 0) {
+    const int64_t n = now_ms();
+    g_searchStartMs.store(n, std::memory_order_relaxed);
     if (infinite || movetime_ms <= 0) {
-        g_endTimeMs.store(0, std::memory_order_relaxed);
-        g_softTimeMs.store(0, std::memory_order_relaxed);
+        g_optimumMs.store(0, std::memory_order_relaxed);
+        g_timer.arm(0, 0);
         return;
     }
-    const int64_t n = now_ms();
-    g_endTimeMs.store(n + movetime_ms, std::memory_order_relaxed);
+    g_optimumMs.store(optimum_ms, std::memory_order_relaxed);
     const int soft = (optimum_ms > 0 ? optimum_ms : (movetime_ms * 7) / 10);
-    g_softTimeMs.store(n + soft, std::memory_order_relaxed);
+    g_timer.arm(n + movetime_ms, n + soft);
+}
+
+inline void start_timer(int movetime_ms, bool infinite, int optimum_ms = 0) {
+    g_stop.store(false, std::memory_order_relaxed);
+    arm_deadlines(movetime_ms, infinite, optimum_ms);
 }
 
 inline bool soft_time_up() {
-    const int64_t s = g_softTimeMs.load(std::memory_order_relaxed);
-    return s > 0 && now_ms() >= s;
+    return g_softExpired.load(std::memory_order_relaxed);
 }
 
 inline void stop() {
     g_stop.store(true, std::memory_order_relaxed);
 }
 
-} // namespace search
+} // namespace search
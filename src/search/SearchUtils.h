@@ -2,10 +2,30 @@
 
 #include <algorithm>
 
+#include "SearchConfig.h"
+
 namespace search {
 
 inline int clampi(int v, int lo, int hi) {
     return (v < lo) ? lo : ((v > hi) ? hi : v);
 }
 
-} // namespace search
+// Mate scores are stored in the TT relative to the node (distance to mate from
+// the stored position) and rebased to the probing ply on the way out.
+inline int score_to_tt(int score, int ply) {
+    if (score >= MATE_BOUND)
+        return score + ply;
+    if (score <= -MATE_BOUND)
+        return score - ply;
+    return score;
+}
+
+inline int score_from_tt(int score, int ply) {
+    if (score >= MATE_BOUND)
+        return score - ply;
+    if (score <= -MATE_BOUND)
+        return score + ply;
+    return score;
+}
+
+} // namespace search
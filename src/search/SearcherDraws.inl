@@ -0,0 +1,71 @@
+    // Seed the key stack with the game history so repetitions across the root are seen.
+    // The root position ends up at keyStack[keyPly]; a node at ply p lives at keyPly + p.
+    inline void set_root_history(const Position& pos, const std::vector<uint64_t>& gameKeys) {
+        const int maxHist = KEY_STACK_MAX - MAX_PLY - 1;
+        int n = (int)gameKeys.size();
+        if (n > 0 && gameKeys[n - 1] == pos.zobKey)
+            n--; // the root itself is written below
+        const int keep = std::min({n, pos.halfmoveClock, maxHist});
+        keyPly = 0;
+        for (int i = n - keep; i < n; i++)
+            keyStack[keyPly++] = gameKeys[i];
+        keyStack[keyPly] = pos.zobKey;
+    }
+
+    // True if the position at this ply already occurred since the last irreversible move.
+    inline bool is_repetition(const Position& pos, int ply) {
+        const int cur = keyPly + ply;
+        keyStack[cur] = pos.zobKey;
+        const int lim = std::min(pos.halfmoveClock, cur);
+        for (int i = 4; i <= lim; i += 2) {
+            if (keyStack[cur - i] == pos.zobKey)
+                return true;
+        }
+        return false;
+    }
+
+    // Node-entry draw test: repetition, fifty-move rule, or dead material.
+    inline bool is_draw(const Position& pos, int ply) {
+        if (is_repetition(pos, ply))
+            return true;
+        if (pos.halfmoveClock >= 100 && !in_check_at(pos, ply))
+            return true;
+        return pos.has_insufficient_material();
+    }
+
+    // True if the side to move has a reversible move back to a position of the current
+    // search path (cuckoo lookup on the key difference). Only in-tree cycles are used, so
+    // the draw is guaranteed regardless of which side owns the move.
+    inline bool has_upcoming_repetition(const Position& pos, int ply) {
+        const int end = std::min(pos.halfmoveClock, ply - 1);
+        if (end < 3)
+            return false;
+        const int cur = keyPly + ply;
+        for (int i = 3; i <= end; i += 2) {
+            const uint64_t moveKey = pos.zobKey ^ keyStack[cur - i];
+            int j = CuckooTables::h1(moveKey);
+            if (g_cuckoo.keys[j] != moveKey) {
+                j = CuckooTables::h2(moveKey);
+                if (g_cuckoo.keys[j] != moveKey)
+                    continue;
+            }
+            const Move m = g_cuckoo.moves[j];
+            const int s1 = from_sq(m);
+            const int s2 = to_sq(m);
+            const int df = file_of(s2) - file_of(s1);
+            const int dr = rank_of(s2) - rank_of(s1);
+            bool clear = true;
+            if (std::abs(df * dr) != 2) { // sliders and king: squares strictly between must be empty
+                const int step = (dr > 0 ? 8 : (dr < 0 ? -8 : 0)) + (df > 0 ? 1 : (df < 0 ? -1 : 0));
+                for (int sq = s1 + step; sq != s2; sq += step) {
+                    if (pos.board[sq] != NO_PIECE) {
+                        clear = false;
+                        break;
+                    }
+                }
+            }
+            if (clear)
+                return true;
+        }
+        return false;
+    }
@@ -1,14 +1,15 @@
+    template <bool Stats>
     inline bool is_legal_move_here(const Position& pos, Move m, int /*plyCtx*/) {
         if (!m)
             return false;
-        if (collect_stats())
+        if constexpr (Stats)
             ss.legCalls++;
         Position p = pos;
         std::vector<Move> legal;
         legal.reserve(256);
         movegen::generate_legal(p, legal);
         const bool ok = (std::find(legal.begin(), legal.end(), m) != legal.end());
-        if (collect_stats()) {
+        if constexpr (Stats) {
             if (!ok)
                 ss.legFail++;
             else {
@@ -24,4 +25,17 @@
             }
         }
         return ok;
-    }
+    }
+
+    // Check status of the node at `ply`, recorded by the parent from gives_check so
+    // children do not rescan for attackers. Falls back to a scan when unknown.
+    inline void set_check_at(int ply, bool inCheck) {
+        inCheckCache[ply] = inCheck;
+        inCheckCacheValid[ply] = true;
+    }
+
+    inline bool in_check_at(const Position& pos, int ply) {
+        if (inCheckCacheValid[ply])
+            return inCheckCache[ply];
+        return attacks::in_check(pos, pos.side);
+    }
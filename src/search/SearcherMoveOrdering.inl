@@ -1,4 +1,12 @@
-    inline int move_score(const Position& pos, Move m, Move ttMove, int ply, int /*prevFrom*/, int /*prevTo*/) {
+    static constexpr int CAPTURE_HISTORY_MAX = 16384;
+
+    inline int& capture_history_ref(const Position& pos, Move m) {
+        const Piece attacker = pos.board[from_sq(m)];
+        const PieceType victim = (flags_of(m) & MF_EP) ? PAWN : type_of(pos.board[to_sq(m)]);
+        return captureHistory[int(attacker) & 15][to_sq(m)][int(victim)];
+    }
+
+    inline int move_score(const Position& pos, Move m, Move ttMove, int ply, int prevFrom, int prevTo) {
         if (m == ttMove)
             return 2000000000;
 
@@ -9,7 +17,7 @@
         if (cap) {
             const Piece victim = (flags_of(m) & MF_EP) ? make_piece(flip_color(pos.side), PAWN) : pos.board[to];
             const Piece attacker = pos.board[from];
-            return 1000000 + mvv_lva(victim, attacker);
+            return 1000000 + mvv_lva(victim, attacker) + capture_history_ref(pos, m) / 16;
         }
 
         int sc = 0;
@@ -18,8 +26,32 @@
             sc += 900000;
         else if (killer[1][p] == m)
             sc += 800000;
+        else if (prevFrom >= 0 && countermove[prevFrom][prevTo] == m)
+            sc += 300000;
 
         const int ci = color_index(pos.side);
         sc += history[ci][from][to];
         return sc;
-    }
+    }
+
+    // Move m failed high: reward it in the killer/history/countermove tables (or capture
+    // history) and penalise the captures searched before it.
+    inline void update_cutoff_history(const Position& pos, Move m, bool cap, int depth, int ply, int prevFrom,
+                                      int prevTo, const Move* capsTried, int capsTriedN) {
+        const int bonus = 1200 + depth * depth * 20;
+        if (!cap) {
+            const int p = std::min(ply, 127);
+            if (killer[0][p] != m) {
+                killer[1][p] = killer[0][p];
+                killer[0][p] = m;
+            }
+            const int ci = color_index(pos.side);
+            update_stat(history[ci][from_sq(m)][to_sq(m)], bonus);
+            if (prevFrom >= 0)
+                countermove[prevFrom][prevTo] = m;
+        } else {
+            update_stat(capture_history_ref(pos, m), bonus, CAPTURE_HISTORY_MAX);
+        }
+        for (int k = 0; k < capsTriedN; k++)
+            update_stat(capture_history_ref(pos, capsTried[k]), -bonus, CAPTURE_HISTORY_MAX);
+    }
@@ -1,116 +1,259 @@
-    int negamax(Position& pos, int depth, int alpha, int beta, int ply, int /*prevFrom*/, int /*prevTo*/, int lastTo,
-                bool lastWasCap, PVLine& outPV) {
+    // Principal variation search, specialised on node type. Root iterates rootMoves in the
+    // order prepared by think(); NonPV nodes always carry a zero window and keep no PV.
+    // cutNode marks zero-window nodes expected to fail high. Stats selects the instrumented
+    // instantiation.
+    template <NodeType NT, bool Stats>
+    int negamax(Position& pos, int depth, int alpha, int beta, int ply, int prevFrom, int prevTo, int lastTo,
+                bool lastWasCap, PVLine& outPV, bool cutNode) {
+        constexpr bool rootNode = (NT == Root);
+        constexpr bool pvNode = (NT != NonPV);
+
         outPV.len = 0;
-        if (stop_or_time_up(false))
-            return eval::evaluate(pos);
+        if (stop_or_time_up())
+            return static_eval<Stats>(pos);
 
         if (ply >= MAX_PLY - 2)
-            return eval::evaluate(pos);
+            return static_eval<Stats>(pos);
 
         add_node();
 
+        if constexpr (!rootNode) {
+            if (is_draw(pos, ply))
+                return 0;
+        }
+
         if (depth <= 0)
-            return qsearch(pos, alpha, beta, ply, lastTo, lastWasCap);
+            return qsearch<Stats>(pos, alpha, beta, ply, lastTo, lastWasCap);
+
+        if constexpr (!rootNode) {
+            // Upcoming repetition: the side to move can force a draw, so alpha is at least 0.
+            if (alpha < 0 && has_upcoming_repetition(pos, ply)) {
+                alpha = 0;
+                if (alpha >= beta)
+                    return alpha;
+            }
+
+            // Mate distance pruning: no line from here can beat a mate already found closer to the root.
+            alpha = std::max(alpha, -MATE + ply);
+            beta = std::min(beta, MATE - ply - 1);
+            if (alpha >= beta)
+                return alpha;
+        }
+        const int alphaOrig = alpha;
+        const bool inCheck = in_check_at(pos, ply);
 
         std::vector<Move>& mv = plyMoves[ply];
         mv.clear();
-        movegen::generate_legal(pos, mv);
-        if (mv.empty()) {
-            if (attacks::in_check(pos, pos.side))
-                return -MATE + ply;
-            return 0;
+        if constexpr (rootNode) {
+            for (const RootMove& rm : rootMoves)
+                mv.push_back(rm.move);
+        } else {
+            movegen::generate_legal(pos, mv);
+            if (mv.empty())
+                return inCheck ? -MATE + ply : 0;
         }
 
         Move ttMove = 0;
-        TTEntry te{};
-        if (stt->probe_copy(pos.zobKey, te)) {
-            ss.ttProbe++;
-            ss.ttHit++;
-            ttMove = te.best;
-            if (te.depth >= depth) {
-                if (te.flag == TT_EXACT) {
-                    ss.ttCut++;
-                    return te.score;
-                }
-                if (te.flag == TT_ALPHA && te.score <= alpha) {
-                    ss.ttCut++;
-                    return te.score;
+        if constexpr (!rootNode) {
+            TTEntry te{};
+            if constexpr (Stats)
+                ss.ttProbe++;
+            if (stt->probe_copy(pos.zobKey, te)) {
+                if constexpr (Stats)
+                    ss.ttHit++;
+                ttMove = te.best;
+                if (te.depth >= depth) {
+                    const int ttScore = score_from_tt(te.score, ply);
+                    if (te.flag == TT_EXACT || (te.flag == TT_ALPHA && ttScore <= alpha) ||
+                        (te.flag == TT_BETA && ttScore >= beta)) {
+                        if constexpr (Stats)
+                            ss.ttCut++;
+                        return ttScore;
+                    }
                 }
-                if (te.flag == TT_BETA && te.score >= beta) {
-                    ss.ttCut++;
-                    return te.score;
+                if constexpr (Stats) {
+                    if (ttMove)
+                        ss.ttMoveAvail++;
                 }
             }
-            if (ttMove)
-                ss.ttMoveAvail++;
+
+            // Internal iterative reduction: a PV or cut node without a TT move is likely badly
+            // ordered, so search it one ply shallower and let the next iteration fill the TT.
+            if ((pvNode || cutNode) && !ttMove && depth >= IIR_MIN_DEPTH) {
+                depth--;
+                ps.iirApplied++;
+            }
         }
 
-        std::vector<int>& sc = plyScores[ply];
         std::vector<int>& ord = plyOrder[ply];
-        sc.resize(mv.size());
         ord.resize(mv.size());
-        for (int i = 0; i < (int)mv.size(); i++) {
-            sc[i] = move_score(pos, mv[i], ttMove, ply, -1, -1);
+        for (int i = 0; i < (int)mv.size(); i++)
             ord[i] = i;
+        if constexpr (!rootNode) {
+            std::vector<int>& sc = plyScores[ply];
+            sc.resize(mv.size());
+            for (int i = 0; i < (int)mv.size(); i++)
+                sc[i] = move_score(pos, mv[i], ttMove, ply, prevFrom, prevTo);
+            std::sort(ord.begin(), ord.end(), [&](int a, int b) { return sc[a] > sc[b]; });
         }
-        std::sort(ord.begin(), ord.end(), [&](int a, int b) { return sc[a] > sc[b]; });
 
         int bestScore = -INF;
         Move bestMove = 0;
-        PVLine bestChild{};
+        int bestIndex = -1;
+        bool firstMoveCut = false;
+        PVBuffer<pvNode> bestChildBuf;
+        PVLine& bestChild = pv_buffer(bestChildBuf);
         int legalSearched = 0;
+        Move capsTried[64];
+        int capsTriedN = 0;
+        const attacks::CheckInfo ci = attacks::check_info(pos);
+
+        // ABDADA: at zero-window nodes, children another thread is already searching are
+        // pushed to the end of ord and searched on a second pass.
+        const int firstPassN = (int)ord.size();
+        const bool abdadaNode = !pvNode && abdada && depth >= ABDADA_MIN_DEPTH;
 
         for (int oi = 0; oi < (int)ord.size(); oi++) {
+            if constexpr (rootNode) {
+                if (stop_or_time_up()) [[unlikely]]
+                    break;
+            }
+
             const Move m = mv[ord[oi]];
+            // Every child probes the TT (qsearch for its stored eval), so fetch the entry before do_move.
+            stt->prefetch(pos.key_after(m));
+            // Under YBWC, helpers search parts of this move's subtree at its split points, and
+            // the root itself never splits, so the pool-wide count is this move's effort.
+            const uint64_t nodesBefore = rootNode ? (ybwc ? nodes_searched() : nodes.get()) : 0;
             const bool cap = is_capture(pos, m);
-            Undo u = do_move_counted(pos, m);
+            const bool givesCheck = attacks::gives_check(pos, ci, m);
+            const int newDepth = depth - 1 + check_extension(givesCheck, ply);
+            set_check_at(ply + 1, givesCheck);
+            Undo u = do_move_counted<Stats>(pos, m);
+            const uint64_t childKey = pos.zobKey;
+            if (abdadaNode && oi < firstPassN && legalSearched > 0 && stt->is_busy(childKey)) {
+                pos.undo_move(m, u);
+                ord.push_back(ord[oi]);
+                continue;
+            }
             legalSearched++;
+            if (abdadaNode)
+                stt->set_busy(childKey);
 
-            PVLine child{};
+            // Late quiet root moves are searched shallower first and re-searched on a fail high.
+            int r = 0;
+            if constexpr (rootNode) {
+                if (!cap && !promo_of(m) && !givesCheck && depth >= 6 && oi >= 4) {
+                    r = 1;
+                    if (depth >= 10 && oi >= 10)
+                        r = 2;
+                    r = std::min(r, depth - 2);
+                }
+            }
+
+            PVBuffer<pvNode> childBuf;
+            PVLine& child = pv_buffer(childBuf);
             int score = -INF;
-            if (legalSearched == 1) {
-                score = -negamax(pos, depth - 1, -beta, -alpha, ply + 1, from_sq(m), to_sq(m), to_sq(m), cap, child);
+            if (pvNode && legalSearched == 1) {
+                score = -negamax<PV, Stats>(pos, newDepth, -beta, -alpha, ply + 1, from_sq(m), to_sq(m), to_sq(m), cap, child,
+                                            false);
             } else {
-                score = -negamax(pos, depth - 1, -alpha - 1, -alpha, ply + 1, from_sq(m), to_sq(m), to_sq(m), cap, child);
-                if (score > alpha && score < beta) {
-                    PVLine child2{};
-                    score = -negamax(pos, depth - 1, -beta, -alpha, ply + 1, from_sq(m), to_sq(m), to_sq(m), cap, child2);
-                    child = child2;
+                if (Stats && rootNode)
+                    ss.rootNonFirstTried++;
+                const int rd = std::max(0, newDepth - r);
+                // The eldest child of a zero-window node alternates cut/all; later children are expected cut nodes.
+                const bool childCut = (pvNode || legalSearched > 1) ? true : !cutNode;
+                score = -negamax<NonPV, Stats>(pos, rd, -alpha - 1, -alpha, ply + 1, from_sq(m), to_sq(m), to_sq(m), cap,
+                                               child, childCut);
+                if (pvNode && score > alpha && score < beta) {
+                    if (Stats && rootNode) {
+                        ss.rootPvsReSearch++;
+                        if (r > 0)
+                            ss.rootLmrReSearch++;
+                    }
+                    score = -negamax<PV, Stats>(pos, newDepth, -beta, -alpha, ply + 1, from_sq(m), to_sq(m), to_sq(m), cap,
+                                                child, false);
                 }
             }
+            if (abdadaNode)
+                stt->clear_busy(childKey);
             pos.undo_move(m, u);
 
+            if constexpr (rootNode) {
+                RootMove& rm = rootMoves[oi];
+                rm.nodes += (ybwc ? nodes_searched() : nodes.get()) - nodesBefore;
+                // An interrupted root iteration is discarded by think().
+                if (stop_or_time_up()) [[unlikely]]
+                    return bestScore;
+                if (legalSearched == 1 || score > alpha) {
+                    rm.score = score;
+                    rm.bound = (score <= alphaOrig) ? TT_ALPHA : (score >= beta ? TT_BETA : TT_EXACT);
+                    if (rm.bound == TT_EXACT)
+                        rm.avgScore = (rm.avgScore == -INF) ? score : (2 * score + rm.avgScore) / 3;
+                    rm.pv.m[0] = m;
+                    rm.pv.len = std::min(127, child.len + 1);
+                    std::copy(child.m, child.m + rm.pv.len - 1, rm.pv.m + 1);
+                } else {
+                    rm.score = -INF;
+                    rm.bound = TT_EXACT;
+                }
+            }
+
             if (score > bestScore) {
                 bestScore = score;
                 bestMove = m;
-                bestChild = child;
+                bestIndex = oi;
+                if constexpr (pvNode)
+                    bestChild = child;
             }
             if (score > alpha)
                 alpha = score;
             if (alpha >= beta) {
                 ps.betaCutoff++;
-                if (!cap) {
-                    const int p = std::min(ply, 127);
-                    if (killer[0][p] != m) {
-                        killer[1][p] = killer[0][p];
-                        killer[0][p] = m;
+                firstMoveCut = (oi == 0);
+                update_cutoff_history(pos, m, cap, depth, ply, prevFrom, prevTo, capsTried, capsTriedN);
+                break;
+            }
+            if (cap && capsTriedN < 64)
+                capsTried[capsTriedN++] = m;
+
+            // YBWC: the eldest brother is done without a cutoff, so idle threads may share the rest.
+            if constexpr (!rootNode) {
+                if (ybwc && depth >= SPLIT_MIN_DEPTH && oi + 2 < (int)ord.size() &&
+                    split<NT, Stats>(pos, mv, ord, oi + 1, depth, alpha, beta, ply, ci, bestScore, bestMove, bestChild)) {
+                    if (bestScore >= beta) {
+                        ps.betaCutoff++;
+                        update_cutoff_history(pos, bestMove, is_capture(pos, bestMove), depth, ply, prevFrom, prevTo,
+                                              capsTried, capsTriedN);
                     }
-                    const int ci = color_index(pos.side);
-                    update_stat(history[ci][from_sq(m)][to_sq(m)], 1200 + depth * depth * 20);
+                    break;
                 }
-                break;
             }
         }
 
-        outPV.m[0] = bestMove;
-        outPV.len = (bestMove ? 1 : 0);
-        for (int i = 0; i < bestChild.len && outPV.len < 128; i++)
-            outPV.m[outPV.len++] = bestChild.m[i];
+        if constexpr (rootNode) {
+            if (Stats && legalSearched > 0) {
+                ss.rootIters++;
+                if (bestIndex == 0 || firstMoveCut)
+                    ss.rootFirstBestOrCut++;
+            }
+        }
+
+        if constexpr (pvNode) {
+            outPV.m[0] = bestMove;
+            outPV.len = (bestMove ? 1 : 0);
+            for (int i = 0; i < bestChild.len && outPV.len < 128; i++)
+                outPV.m[outPV.len++] = bestChild.m[i];
+        }
+
+        // Scores from an aborted subtree (stop, or a cutoff at a split point above) are not stored.
+        if (stop_or_time_up())
+            return bestScore;
 
         if (bestMove) {
-            const uint8_t fl = (bestScore >= beta) ? TT_BETA : ((bestScore <= alpha) ? TT_ALPHA : TT_EXACT);
-            stt->store(pos.zobKey, bestMove, (int16_t)bestScore, (int16_t)depth, fl);
+            const uint8_t fl = (bestScore >= beta) ? TT_BETA : ((bestScore <= alphaOrig) ? TT_ALPHA : TT_EXACT);
+            stt->store(pos.zobKey, bestMove, (int16_t)score_to_tt(bestScore, ply), (int16_t)depth, fl);
         }
 
         return bestScore;
-    }
+    }
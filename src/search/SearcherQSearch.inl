@@ -1,41 +1,83 @@
+    template <bool Stats>
     int qsearch(Position& pos, int alpha, int beta, int ply, int /*lastTo*/, bool /*lastWasCap*/) {
         add_node();
         if (ply >= MAX_PLY - 2)
-            return eval::evaluate(pos);
+            return static_eval<Stats>(pos);
 
-        int stand = eval::evaluate(pos);
-        if (stand >= beta)
-            return stand;
-        if (stand > alpha)
-            alpha = stand;
+        keyStack[keyPly + ply] = pos.zobKey;
+        if (alpha < 0 && has_upcoming_repetition(pos, ply)) {
+            alpha = 0;
+            if (alpha >= beta)
+                return alpha;
+        }
+
+        // In check there is no stand-pat: every evasion is searched.
+        const bool inCheck = in_check_at(pos, ply);
+        int stand = -INF;
+        if (!inCheck) {
+            // Static eval lookup: this thread's eval cache, then the TT (shared by all threads).
+            if constexpr (Stats)
+                ss.evalProbe++;
+            if (evalCache.probe(pos.zobKey, stand)) {
+                if constexpr (Stats)
+                    ss.evalCacheHit++;
+            } else {
+                stand = stt->probe_eval(pos.zobKey);
+                if (stand != TT_EVAL_NONE) {
+                    if constexpr (Stats)
+                        ss.evalTTHit++;
+                } else {
+                    stand = static_eval<Stats>(pos);
+                    stt->store_eval(pos.zobKey, stand);
+                }
+                evalCache.store(pos.zobKey, stand);
+            }
+            if (stand >= beta)
+                return stand;
+            if (stand > alpha)
+                alpha = stand;
+        }
 
         std::vector<Move>& mv = plyMoves[ply];
         mv.clear();
         movegen::generate_legal(pos, mv);
+        if (inCheck && mv.empty())
+            return -MATE + ply;
 
         static const int V[7] = {0, 100, 320, 330, 500, 900, 0};
 
+        attacks::CheckInfo ci;
+        bool ciReady = false;
+
         for (Move m : mv) {
             const bool cap = is_capture(pos, m);
             const bool promo = (promo_of(m) != 0);
-            if (!(cap || promo))
-                continue;
-
-            int gain = 0;
-            if (cap) {
-                Piece victim = pos.board[to_sq(m)];
-                if (flags_of(m) & MF_EP)
-                    victim = make_piece(flip_color(pos.side), PAWN);
-                gain += (victim == NO_PIECE) ? 0 : V[type_of(victim)];
+            if (!inCheck) {
+                if (!(cap || promo))
+                    continue;
+
+                int gain = 0;
+                if (cap) {
+                    Piece victim = pos.board[to_sq(m)];
+                    if (flags_of(m) & MF_EP)
+                        victim = make_piece(flip_color(pos.side), PAWN);
+                    gain += (victim == NO_PIECE) ? 0 : V[type_of(victim)];
+                }
+                if (promo)
+                    gain += 800;
+
+                if (stand + gain + 100 <= alpha)
+                    continue;
             }
-            if (promo)
-                gain += 800;
 
-            if (stand + gain + 100 <= alpha)
-                continue;
+            if (!ciReady) {
+                ci = attacks::check_info(pos);
+                ciReady = true;
+            }
+            set_check_at(ply + 1, attacks::gives_check(pos, ci, m));
 
-            Undo u = do_move_counted(pos, m, true);
-            int score = -qsearch(pos, -beta, -alpha, ply + 1, to_sq(m), true);
+            Undo u = do_move_counted<Stats>(pos, m, true);
+            int score = -qsearch<Stats>(pos, -beta, -alpha, ply + 1, to_sq(m), cap);
             pos.undo_move(m, u);
             if (score >= beta)
                 return score;
@@ -43,4 +85,4 @@
                 alpha = score;
         }
         return alpha;
-    }
+    }
@@ -3,4 +3,12 @@
     inline void update_quiet_history(Color /*us*/, int /*prevFrom*/, int /*prevTo*/, int /*from*/, int /*to*/, int /*depth*/,
                                      bool /*good*/) {}
     inline int compute_lmr_reduction(int /*depth*/, int /*legalMovesSearched*/, bool /*inCheck*/, bool /*isQuiet*/,
-                                     bool /*improving*/, bool /*isPv*/) const { return 0; }
+                                     bool /*improving*/, bool /*isPv*/) const { return 0; }
+
+    // Extend checking moves by one ply, capped so check sequences cannot run past twice the iteration depth.
+    inline int check_extension(bool givesCheck, int ply) const { return (givesCheck && ply < 2 * rootDepth) ? 1 : 0; }
+
+    static constexpr int IIR_MIN_DEPTH = 4;
+    static constexpr int ABDADA_MIN_DEPTH = 3;
+    static constexpr int SPLIT_MIN_DEPTH = 4;
+    static constexpr int SPLIT_MAX_HELPERS = 7;
@@ -0,0 +1,212 @@
+    // Where s can be recruited for a split below this thread's activeSplit: the value of
+    // s->idleAt to claim, or nullptr. A waiting owner only takes work under its own split.
+    inline SplitPoint* recruitable(const Searcher* s) const {
+        SplitPoint* at = s->idleAt.load(std::memory_order_relaxed);
+        if (!at || at == any_split())
+            return at;
+        for (const SplitPoint* p = activeSplit; p; p = p->parent) {
+            if (p == at)
+                return at;
+        }
+        return nullptr;
+    }
+
+    // Young Brothers Wait (SMP_YBWC). A node splits only after its eldest brother has been
+    // searched, and only when some pool thread is idle; the owner keeps searching the shared
+    // moves itself, then helps below the split until every helper has left it.
+    template <NodeType NT, bool Stats>
+    bool split(Position& pos, const std::vector<Move>& mv, const std::vector<int>& ord, int first, int depth,
+               int& alpha, int beta, int ply, const attacks::CheckInfo& ci, int& bestScore, Move& bestMove,
+               PVLine& bestChild) {
+        bool anyIdle = false;
+        for (const Searcher* s : g_pool) {
+            if (s != this && recruitable(s)) {
+                anyIdle = true;
+                break;
+            }
+        }
+        if (!anyIdle)
+            return false;
+
+        SplitPoint sp;
+        sp.parent = activeSplit;
+        sp.owner = this;
+        sp.keyPly = keyPly;
+        sp.rootDepth = rootDepth;
+        const int cur = keyPly + ply;
+        sp.keyBase = cur - std::min(pos.halfmoveClock, cur);
+        sp.keys.assign(keyStack + sp.keyBase, keyStack + cur + 1);
+        sp.pos = pos;
+        sp.ci = ci;
+        for (int i = first; i < (int)ord.size() && sp.moveCount < 256; i++)
+            sp.moves[sp.moveCount++] = mv[ord[i]];
+        sp.depth = depth;
+        sp.beta = beta;
+        sp.ply = ply;
+        sp.pvNode = (NT != NonPV);
+        sp.alpha = alpha;
+        sp.bestScore = bestScore;
+        sp.bestMove = bestMove;
+        sp.bestChild = bestChild;
+
+        int recruited = 0;
+        for (Searcher* s : g_pool) {
+            if (recruited >= SPLIT_MAX_HELPERS)
+                break;
+            if (s == this)
+                continue;
+            SplitPoint* at = recruitable(s);
+            if (!at || !s->idleAt.compare_exchange_strong(at, nullptr, std::memory_order_acq_rel))
+                continue;
+            sp.helpers.fetch_add(1, std::memory_order_relaxed);
+            s->splitTask.store(&sp, std::memory_order_release);
+            s->wake_split();
+            recruited++;
+        }
+        if (!recruited)
+            return false;
+
+        activeSplit = &sp;
+        search_split<NT, Stats>(sp, pos);
+        activeSplit = sp.parent;
+
+        help_until_done<Stats>(sp);
+
+        alpha = sp.alpha;
+        bestScore = sp.bestScore;
+        bestMove = sp.bestMove;
+        if constexpr (NT != NonPV)
+            bestChild = sp.bestChild;
+        return true;
+    }
+
+    // Search moves of sp until none are left or the split is cut off. pos is this thread's
+    // own copy of the split position. Later brothers get a zero window around the shared
+    // alpha, re-searched with the full window at PV splits.
+    template <NodeType NT, bool Stats>
+    void search_split(SplitPoint& sp, Position& pos) {
+        const int ply = sp.ply;
+        for (;;) {
+            Move m;
+            int alpha;
+            {
+                std::lock_guard<std::mutex> lk(sp.mtx);
+                if (sp.next >= sp.moveCount || stop_or_time_up())
+                    return;
+                m = sp.moves[sp.next++];
+                alpha = sp.alpha;
+            }
+
+            stt->prefetch(pos.key_after(m));
+            const bool cap = is_capture(pos, m);
+            const bool givesCheck = attacks::gives_check(pos, sp.ci, m);
+            const int newDepth = sp.depth - 1 + check_extension(givesCheck, ply);
+            set_check_at(ply + 1, givesCheck);
+            Undo u = do_move_counted<Stats>(pos, m);
+            PVBuffer<NT != NonPV> childBuf;
+            PVLine& child = pv_buffer(childBuf);
+            int score = -negamax<NonPV, Stats>(pos, newDepth, -alpha - 1, -alpha, ply + 1, from_sq(m), to_sq(m), to_sq(m),
+                                               cap, child, true);
+            if (NT != NonPV && score > alpha && score < sp.beta)
+                score = -negamax<PV, Stats>(pos, newDepth, -sp.beta, -alpha, ply + 1, from_sq(m), to_sq(m), to_sq(m), cap,
+                                            child, false);
+            pos.undo_move(m, u);
+
+            // The score of an interrupted child is meaningless.
+            if (stop_or_time_up())
+                return;
+
+            std::lock_guard<std::mutex> lk(sp.mtx);
+            if (score > sp.bestScore) {
+                sp.bestScore = score;
+                sp.bestMove = m;
+                if constexpr (NT != NonPV)
+                    sp.bestChild = child;
+            }
+            if (score > sp.alpha)
+                sp.alpha = score;
+            if (sp.alpha >= sp.beta)
+                sp.cutoff.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // Work on a split handed to this thread: take on the split owner's search context,
+    // search there, and leave. The owner may return from split() once the count drops.
+    template <bool Stats>
+    void run_split_task(SplitPoint* sp) {
+        keyPly = sp->keyPly;
+        rootDepth = sp->rootDepth;
+        std::copy(sp->keys.begin(), sp->keys.end(), keyStack + sp->keyBase);
+        Position pos = sp->pos;
+
+        SplitPoint* const prevSplit = activeSplit;
+        activeSplit = sp;
+        if (sp->pvNode)
+            search_split<PV, Stats>(*sp, pos);
+        else
+            search_split<NonPV, Stats>(*sp, pos);
+        activeSplit = prevSplit;
+
+        Searcher* const owner = sp->owner;
+        splitTask.store(nullptr, std::memory_order_relaxed);
+        sp->helpers.fetch_sub(1, std::memory_order_release);
+        owner->wake_split();
+    }
+
+    // Helpful master: with its own moves done, the owner of sp parks until the last helper
+    // leaves, and meanwhile takes work at splits below sp. Whatever it searches there lies
+    // deeper than sp, so its own stack frames and per-ply state are left untouched.
+    template <bool Stats>
+    void help_until_done(SplitPoint& sp) {
+        while (sp.helpers.load(std::memory_order_acquire) > 0) {
+            idleAt.store(&sp, std::memory_order_release);
+            {
+                std::unique_lock<std::mutex> lk(splitMtx);
+                splitCv.wait(lk, [&]() {
+                    return splitTask.load(std::memory_order_acquire) || sp.helpers.load(std::memory_order_acquire) == 0;
+                });
+            }
+            SplitPoint* expected = &sp;
+            if (idleAt.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel))
+                continue; // not recruited
+            // Recruited: the task is stored right after the claim.
+            SplitPoint* task;
+            while (!(task = splitTask.load(std::memory_order_acquire)))
+                std::this_thread::yield();
+            run_split_task<Stats>(task);
+        }
+    }
+
+    // Helper thread body for a YBWC search: park until a split is handed over, work there,
+    // and park again until the search ends.
+    template <bool Stats>
+    void ybwc_idle_loop() {
+        isMainSearchThread = false;
+        for (int i = 0; i < MAX_PLY; i++) {
+            staticEvalStack[i] = -INF;
+            pinnedMaskValid[i] = false;
+            inCheckCacheValid[i] = false;
+        }
+        ps.clear();
+        ss.clear();
+
+        for (;;) {
+            idleAt.store(any_split(), std::memory_order_release);
+            {
+                std::unique_lock<std::mutex> lk(splitMtx);
+                splitCv.wait(lk, [&]() {
+                    return splitTask.load(std::memory_order_acquire) || g_ybwc_exit.load(std::memory_order_acquire);
+                });
+            }
+            SplitPoint* sp = splitTask.load(std::memory_order_acquire);
+            if (!sp) {
+                SplitPoint* expected = any_split();
+                if (idleAt.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel))
+                    break;
+                // Claimed just before the exit: the task is on its way.
+                while (!(sp = splitTask.load(std::memory_order_acquire)))
+                    std::this_thread::yield();
+            }
+            run_split_task<Stats>(sp);
+        }
+    }
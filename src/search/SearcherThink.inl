@@ -1,8 +1,8 @@
 ﻿    // Iterative deepening with aspiration windows and root move ordering.
-    Result think(Position& pos, const Limits& lim, bool emitInfo) {
+    template <bool Stats>
+    Result think(Position& pos, const Limits& lim, bool emitInfo, const std::vector<uint64_t>& gameKeys) {
         isMainSearchThread = emitInfo;
-        keyPly = 0;
-        keyStack[keyPly++] = pos.zobKey;
+        set_root_history(pos, gameKeys);
         for (int i = 0; i < MAX_PLY; i++) {
             staticEvalStack[i] = -INF;
             pinnedMaskValid[i] = false;
@@ -10,9 +10,7 @@
         }
 
         Result res{};
-        nodes = 0;
-        nodes_batch = 0;
-        time_check_tick = 0;
+        nodes.reset();
         selDepth = 0;
         ps.clear();
         ss.clear();
@@ -22,31 +20,65 @@
         int lastFlushMs = 0;
         int lastInfoMs = -1000000;
 
-        std::vector<Move> rootMoves;
-        rootMoves.reserve(256);
-        movegen::generate_legal(pos, rootMoves);
+        std::vector<Move>& legalRoot = plyMoves[0];
+        legalRoot.clear();
+        movegen::generate_legal(pos, legalRoot);
 
-        if (rootMoves.empty()) {
-            flush_nodes_batch();
+        if (legalRoot.empty()) {
             res.bestMove = 0;
             res.ponderMove = 0;
             res.score = 0;
-            res.nodes = nodes;
+            res.nodes = nodes.get();
             return res;
         }
 
-        Move bestMove = rootMoves[0];
+        // Seed the root order once from the TT move and the regular move scores; later
+        // iterations reorder by the scores each move earned.
+        {
+            Move ttMove = 0;
+            TTEntry rte{};
+            if (stt->probe_copy(pos.zobKey, rte))
+                ttMove = rte.best;
+            std::vector<int>& sc = plyScores[0];
+            sc.resize(legalRoot.size());
+            rootMoves.resize(legalRoot.size());
+            std::vector<int>& ord = plyOrder[0];
+            ord.resize(legalRoot.size());
+            for (int i = 0; i < (int)legalRoot.size(); i++) {
+                sc[i] = move_score(pos, legalRoot[i], ttMove, 0, -1, -1);
+                ord[i] = i;
+            }
+            std::stable_sort(ord.begin(), ord.end(), [&](int a, int b) { return sc[a] > sc[b]; });
+            for (int i = 0; i < (int)ord.size(); i++) {
+                rootMoves[i] = RootMove{};
+                rootMoves[i].move = legalRoot[ord[i]];
+            }
+        }
+        // Searched moves go by score; the rest keep the history-driven move order.
+        auto sort_root_moves = [&]() {
+            for (RootMove& rm : rootMoves)
+                rm.orderScore = (rm.score == -INF) ? move_score(pos, rm.move, 0, 0, -1, -1) : 0;
+            std::stable_sort(rootMoves.begin(), rootMoves.end(), [](const RootMove& a, const RootMove& b) {
+                if (a.score != b.score)
+                    return a.score > b.score;
+                if (a.prevScore != b.prevScore)
+                    return a.prevScore > b.prevScore;
+                return a.orderScore > b.orderScore;
+            });
+        };
+
+        Move bestMove = rootMoves[0].move;
         int bestScore = -INF;
 
         constexpr int ASP_START = 35;
         constexpr int PV_MAX = 128;
-        // Combine global nodes and local batch for consistent info output.
+        // Sum the per-thread counters for info output.
         auto now_time_nodes_nps = [&]() {
             int t = (int)(now_ms() - startT);
             if (t < 1)
                 t = 1;
 
-            uint64_t nodesAll = g_nodes_total.load(std::memory_order_relaxed) + nodes_batch;
+            uint64_t nodesAll = nodes_searched();
 
             uint64_t npsAll = (nodesAll * 1000ULL) / (uint64_t)t;
 
@@ -68,133 +100,16 @@
             return 4; // quiet
         };
 
-        // Root search with PVS and late-move reductions (root-specific heuristics).
-        auto root_search = [&](int d, int alpha, int beta, Move& outBestMove, int& outBestScore, PVLine& outPV,
-                               bool& outOk) {
-            outOk = true;
-
-            int curAlpha = alpha;
-            int curBeta = beta;
-
-            Move iterBestMove = 0;
-            int iterBestScore = -INF;
+        // Root iteration: negamax<Root> walks rootMoves in order; an interrupted iteration is discarded.
+        auto root_search = [&](int d, int alpha, int beta, Move& outBestMove, int& outBestScore, PVLine& outPV) {
             PVLine iterPV;
-            iterPV.len = 0;
-            int iterBestIndex = -1;
-            bool firstMoveCut = false;
-
-            int rootLegalsSearched = 0;
-            const bool splitActive = (!isMainSearchThread && rootSplitStride > 1 &&
-                                      (int)rootMoves.size() >= rootSplitStride);
-
-            for (int i = 0; i < (int)rootMoves.size(); i++) {
-                if (splitActive && ((i % rootSplitStride) != rootSplitOffset))
-                    continue;
-                if (stop_or_time_up(true)) [[unlikely]] {
-                    outOk = false;
-                    break;
-                }
-
-                Move m = rootMoves[i];
-                const uint16_t flags = flags_of(m);
-                const int to = to_sq(m);
-
-                const bool isCap = ((flags & MF_EP) != 0) || (pos.board[to] != NO_PIECE);
-                const bool isPromo = (promo_of(m) != 0);
-
-                Undo u = do_move_counted(pos, m);
-
-                rootLegalsSearched++;
-
-                bool givesCheck = false;
-                if (d >= 6 && i >= 4) {
-                    givesCheck = attacks::in_check(pos, pos.side);
-                }
-
-                const int nextLastTo = to;
-                const bool nextLastWasCap = isCap;
-
-                int score = -INF;
-
-                int r = 0;
-                if (!isCap && !isPromo && !givesCheck && d >= 6 && i >= 4) {
-                    r = 1;
-                    if (d >= 10 && i >= 10)
-                        r = 2;
-                    r = std::min(r, d - 2);
-                }
-
-                PVLine childPV;
-
-                const int curFrom = from_sq(m);
-                const int curTo = to_sq(m);
-
-                if (rootLegalsSearched == 1) {
-                    score = -negamax(pos, d - 1, -curBeta, -curAlpha, 1, curFrom, curTo, nextLastTo, nextLastWasCap,
-                                     childPV);
-                } else {
-                    if (collect_stats())
-                        ss.rootNonFirstTried++;
-                    int rd = (d - 1) - r;
-                    if (rd < 0)
-                        rd = 0;
-
-                    score = -negamax(pos, rd, -curAlpha - 1, -curAlpha, 1, curFrom, curTo, nextLastTo, nextLastWasCap,
-                                     childPV);
-
-                    if (score > curAlpha && score < curBeta) {
-                        if (collect_stats()) {
-                            ss.rootPvsReSearch++;
-                            if (r > 0)
-                                ss.rootLmrReSearch++;
-                        }
-                        PVLine childPV2;
-                        score = -negamax(pos, d - 1, -curBeta, -curAlpha, 1, curFrom, curTo, nextLastTo, nextLastWasCap,
-                                         childPV2);
-                        childPV = childPV2;
-                    }
-                }
-
-                pos.undo_move(m, u);
-
-                if (stop_or_time_up(true)) [[unlikely]] {
-                    outOk = false;
-                    break;
-                }
-
-                if (score > iterBestScore) {
-                    iterBestScore = score;
-                    iterBestMove = m;
-                    iterBestIndex = i;
-
-                    iterPV.m[0] = m;
-                    iterPV.len = std::min(127, childPV.len + 1);
-                    for (int k = 0; k < childPV.len && k + 1 < 128; k++) {
-                        iterPV.m[k + 1] = childPV.m[k];
-                    }
-                }
-
-                if (score > curAlpha)
-                    curAlpha = score;
-                if (curAlpha >= curBeta) {
-                    if (i == 0)
-                        firstMoveCut = true;
-                    break;
-                }
-            }
-
-            if (rootLegalsSearched == 0)
-                outOk = false;
-
-            if (collect_stats() && rootLegalsSearched > 0) {
-                ss.rootIters++;
-                if (iterBestIndex == 0 || firstMoveCut)
-                    ss.rootFirstBestOrCut++;
-            }
-
-            outBestMove = iterBestMove;
-            outBestScore = iterBestScore;
+            const int score = negamax<Root, Stats>(pos, d, alpha, beta, 0, -1, -1, -1, false, iterPV, false);
+            if (stop_or_time_up() || !iterPV.len)
+                return false;
+            outBestMove = iterPV.m[0];
+            outBestScore = score;
             outPV = iterPV;
+            return true;
         };
 
         Move prevIterBestMove = 0;
@@ -204,47 +119,40 @@
         bool prevHadRazor = false;
         Move softPrevBestMove = 0;
         int softStableIters = 0;
+        int prevDepthScore = 0;
+
+        // Helper depth-skipping (Lazy SMP only): thread i searches only depths where
+        // ((d + phase) / size) is even, so helpers run ahead of the main thread on different
+        // depths. ABDADA threads search the same iteration together, or busy flags never match.
+        static constexpr int SKIP_N = 20;
+        static constexpr int SKIP_SIZE[SKIP_N] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+        static constexpr int SKIP_PHASE[SKIP_N] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+        int completedDepth = 0;
 
         for (int d = 1; d <= maxDepth; d++) {
-            if (stop_or_time_up(true)) [[unlikely]]
+            if (stop_or_time_up()) [[unlikely]]
                 break;
 
-            if (bestMove) {
-                auto it = std::find(rootMoves.begin(), rootMoves.end(), bestMove);
-                if (it != rootMoves.end())
-                    std::swap(rootMoves[0], *it);
+            if (!isMainSearchThread && !abdada && d > 1) {
+                const int i = (threadIndex - 1) % SKIP_N;
+                if (((d + SKIP_PHASE[i]) / SKIP_SIZE[i]) % 2)
+                    continue;
             }
 
-            std::vector<int> rootScores(rootMoves.size());
-            for (int i = 0; i < (int)rootMoves.size(); i++)
-                rootScores[i] = move_score(pos, rootMoves[i], bestMove, 0, -1, -1);
-
-            const int K = std::min<int>(g_params.rootOrderK, (int)rootMoves.size());
-            for (int i = 0; i < K; i++) {
-                int bi = i, bs = rootScores[i];
-                for (int j = i + 1; j < (int)rootMoves.size(); j++) {
-                    if (rootScores[j] > bs) {
-                        bs = rootScores[j];
-                        bi = j;
-                    }
-                }
-                if (bi != i) {
-                    std::swap(rootMoves[i], rootMoves[bi]);
-                    std::swap(rootScores[i], rootScores[bi]);
-                }
-            }
+            for (RootMove& rm : rootMoves)
+                rm.prevScore = rm.score;
 
-            const bool useAsp = (d > 5 && bestScore > -INF / 2 && bestScore < INF / 2);
-            int asp = ASP_START;
-            const int scoreSwing = std::abs(bestScore - prevIterScore);
-            asp += std::min(64, scoreSwing / 4);
+            const bool useAsp = (d > 5 && bestScore > -MATE_BOUND && bestScore < MATE_BOUND);
+            int delta = ASP_START;
+            const int scoreSwing = std::abs(bestScore - prevDepthScore);
+            delta += std::min(64, scoreSwing / 4);
             if (!isMainSearchThread) {
                 // Stockfish-inspired per-thread aspiration diversification:
                 // wider and slightly jittered windows reduce same-line re-search overlap.
-                asp += 24 + ((threadIndex & 7) << 2);
+                delta += 24 + ((threadIndex & 7) << 2);
             }
-            int alpha = useAsp ? (bestScore - asp) : -INF;
-            int beta = useAsp ? (bestScore + asp) : INF;
+            int alpha = useAsp ? std::max(bestScore - delta, -INF) : -INF;
+            int beta = useAsp ? std::min(bestScore + delta, INF) : INF;
 
             Move localBestMove = bestMove;
             int localBestScore = bestScore;
@@ -255,7 +163,7 @@
             Move rootTTMove = 0;
             {
                 TTEntry rte{};
-                if (stt->probe_copy(pos.zobKey, rte) && rte.best && is_legal_move_here(pos, rte.best, 0))
+                if (stt->probe_copy(pos.zobKey, rte) && rte.best && is_legal_move_here<Stats>(pos, rte.best, 0))
                     rootTTMove = rte.best;
             }
 
@@ -263,34 +171,47 @@
             const uint64_t pRfp0 = ps.rfpPrune;
             const uint64_t pNull0 = ss.nullTried;
 
-            root_search(d, alpha, beta, localBestMove, localBestScore, localPV, ok);
-            if (!ok)
-                break;
+            // Aspiration loop: widen only the bound that failed, growing the step by half
+            // each time. Fail-high re-searches run a ply shallower per consecutive fail high.
+            int failHighCount = 0;
+            while (true) {
+                rootDepth = std::max(1, d - failHighCount);
+                ok = root_search(rootDepth, alpha, beta, localBestMove, localBestScore, localPV);
+                sort_root_moves();
+                if (!ok)
+                    break;
 
-            if (useAsp && (localBestScore <= alpha || localBestScore >= beta)) {
-                if (collect_stats())
+                if (localBestScore <= alpha) {
+                    alpha = std::max(localBestScore - delta, -INF);
+                    failHighCount = 0;
+                } else if (localBestScore >= beta) {
+                    beta = std::min(localBestScore + delta, INF);
+                    failHighCount++;
+                } else {
+                    break;
+                }
+                if constexpr (Stats)
                     ss.aspFail++;
                 iterAspFailed = true;
-                if (isMainSearchThread) {
-                    alpha = -INF;
-                    beta = INF;
-                    root_search(d, alpha, beta, localBestMove, localBestScore, localPV, ok);
-                    if (!ok)
-                        break;
-                }
+                delta += delta / 2;
             }
+            rootDepth = d;
+            if (!ok)
+                break;
 
             // If current root PV is too short, rebuild it with a single full-window
             // confirmation on the current best move.
-            if (isMainSearchThread && ok && localBestMove && d >= 8 && localPV.len < 4 && !stop_or_time_up(true)) {
+            if (isMainSearchThread && ok && localBestMove && d >= 8 && localPV.len < 4 && !stop_or_time_up()) {
                 const int bf = from_sq(localBestMove);
                 const int bt = to_sq(localBestMove);
                 const bool bcap = is_capture(pos, localBestMove) || (flags_of(localBestMove) & MF_EP);
-                Undo u = do_move_counted(pos, localBestMove);
+                const bool bchk = attacks::gives_check(pos, attacks::check_info(pos), localBestMove);
+                set_check_at(1, bchk);
+                Undo u = do_move_counted<Stats>(pos, localBestMove);
                 PVLine fullChild;
-                int fullScore = -negamax(pos, d - 1, -INF, INF, 1, bf, bt, bt, bcap, fullChild);
+                int fullScore = -negamax<PV, Stats>(pos, d - 1 + check_extension(bchk, 0), -INF, INF, 1, bf, bt, bt, bcap, fullChild, false);
                 pos.undo_move(localBestMove, u);
-                if (!stop_or_time_up(true)) {
+                if (!stop_or_time_up()) {
                     localBestScore = fullScore;
                     localPV.m[0] = localBestMove;
                     localPV.len = std::min(127, fullChild.len + 1);
@@ -299,7 +220,7 @@
                 }
             }
 
-            if (collect_stats()) {
+            if constexpr (Stats) {
                 ss.rootBestSrc[classify_root_source(localBestMove, rootTTMove)]++;
                 const bool hadRazor = (ps.razorPrune > pRazor0);
                 const bool hadRfp = (ps.rfpPrune > pRfp0);
@@ -320,9 +241,12 @@
                 prevIterScore = localBestScore;
             }
 
+            const int scoreDrop = (bestScore > -INF / 2) ? bestScore - localBestScore : 0;
+            prevDepthScore = bestScore;
             bestMove = localBestMove;
             bestScore = localBestScore;
             rootPV = localPV;
+            completedDepth = d;
 
             if (bestMove && bestMove == softPrevBestMove)
                 softStableIters++;
@@ -331,9 +255,27 @@
                 softStableIters = 0;
             }
 
+            // Read the budget each iteration: ponderhit can turn an untimed search into a timed one.
+            const int optimum = g_optimumMs.load(std::memory_order_relaxed);
+            const int64_t clockStart = g_searchStartMs.load(std::memory_order_relaxed);
+
+            // Clock mode: rescale the soft deadline by best-move stability, score drops and
+            // the share of the search's root nodes spent on the best move.
+            if (isMainSearchThread && optimum > 0 && d > 1) {
+                uint64_t rootNodes = 0, bestNodes = 0;
+                for (const RootMove& rm : rootMoves) {
+                    rootNodes += rm.nodes;
+                    if (rm.move == bestMove)
+                        bestNodes = rm.nodes;
+                }
+                const double effort = rootNodes ? double(bestNodes) / double(rootNodes) : 1.0;
+                const double scale = soft_time_scale(softStableIters, scoreDrop, effort);
+                g_timer.set_soft(clockStart + int64_t(optimum * scale));
+            }
+
             if (emitInfo) {
                 auto [t, nps, nodesAll] = now_time_nodes_nps();
-                rootPVLegal = sanitize_pv_from_root(pos, rootPV, PV_MAX);
+                rootPVLegal = sanitize_pv_from_root<Stats>(pos, rootPV, PV_MAX);
                 int hashfull = stt->hashfull_permille();
                 int sd = std::max(1, selDepth);
 
@@ -359,23 +301,30 @@
                 lastInfoMs = t;
             }
 
-            // Soft time budget: stop only when PV is reasonably stable.
+            // Soft time budget. In clock mode the deadline already reflects stability;
+            // fixed movetime stops early only when the PV is reasonably stable.
             if (soft_time_up()) [[unlikely]] {
-                const bool deepEnough = (d >= 8);
-                const bool stableEnough = (softStableIters >= 1);
+                const bool deepEnough = (optimum > 0 || d >= 8);
+                const bool stableEnough = (optimum > 0 || softStableIters >= 1);
                 if (deepEnough && stableEnough && !iterAspFailed)
                     break;
             }
+            // Clock mode: an iteration past 60% of the soft budget would most likely overrun it.
+            if (isMainSearchThread && optimum > 0 && !iterAspFailed) {
+                const int64_t soft = g_softTimeMs.load(std::memory_order_relaxed);
+                if (soft > 0 && (now_ms() - clockStart) * 10 > (soft - clockStart) * 6)
+                    break;
+            }
         }
 
-        flush_nodes_batch();
-
         res.bestMove = bestMove;
         res.score = bestScore;
-        res.nodes = nodes;
+        res.nodes = nodes.get();
+        res.depth = completedDepth;
 
-        rootPVLegal = sanitize_pv_from_root(pos, rootPV, PV_MAX);
+        rootPVLegal = sanitize_pv_from_root<Stats>(pos, rootPV, PV_MAX);
         res.ponderMove = (rootPVLegal.len >= 2 ? rootPVLegal.m[1] : 0);
+        res.pv.assign(rootPVLegal.m, rootPVLegal.m + rootPVLegal.len);
 
         if (emitInfo) {
             std::cout << "info string prune razor=" << ps.razorPrune << " rfp=" << ps.rfpPrune
@@ -383,7 +332,7 @@
                       << " qfut=" << ps.quietFutility << " qlim=" << ps.quietLimit
                       << " csee=" << ps.capSeePrune << " iir=" << ps.iirApplied << " lmr=" << ps.lmrApplied
                       << " bcut=" << ps.betaCutoff << "\n";
-            if (collect_stats()) {
+            if constexpr (Stats) {
                 uint64_t rootDen = ss.rootIters ? ss.rootIters : 1;
                 uint64_t ttDen = ss.ttProbe ? ss.ttProbe : 1;
                 uint64_t ttMoveDen = ss.ttMoveAvail ? ss.ttMoveAvail : 1;
@@ -407,6 +356,12 @@
                           << " tt_cut=" << pct(ss.ttCut, ttDen) << " ttm_first=" << pct(ss.ttMoveFirst, ttMoveDen)
                           << "\n";
 
+                const uint64_t evalDen = ss.evalProbe ? ss.evalProbe : 1;
+                std::cout << "info string stats_eval probes=" << ss.evalProbe
+                          << " cache_hit=" << pct(ss.evalCacheHit, evalDen) << " tt_hit=" << pct(ss.evalTTHit, evalDen)
+                          << " computed=" << pct(ss.evalProbe - ss.evalCacheHit - ss.evalTTHit, evalDen)
+                          << " pawn_hit=" << pct(ss.pawnHit, ss.pawnProbe) << "\n";
+
                 std::cout << "info string stats_lmr red=" << ss.lmrTried << " re=" << pct(ss.lmrResearched, lmrDen)
                           << " rk=" << ss.lmrReducedByBucket[0] << " rc=" << ss.lmrReducedByBucket[1]
                           << " rh=" << ss.lmrReducedByBucket[2] << " rl=" << ss.lmrReducedByBucket[3]
@@ -416,7 +371,7 @@
                 std::cout << "info string stats_prune null_t=" << ss.nullTried << " null_fh=" << ss.nullCut
                           << " null_vf=" << ss.nullVerifyFail << " raz=" << ps.razorPrune << " rfp=" << ps.rfpPrune
                           << " rev_null=" << ss.proxyReversalAfterNull << " rev_rfp=" << ss.proxyReversalAfterRfp
-                          << " rev_raz=" << ss.proxyReversalAfterRazor << " tchk=" << ss.timeChecks
+                          << " rev_raz=" << ss.proxyReversalAfterRazor
                           << " leg=" << ss.legCalls << " legf=" << ss.legFail << " seem=" << ss.seeCallsMain
                           << " seeq=" << ss.seeCallsQ << " seefs=" << ss.seeFastSafe << " mk=" << ss.makeCalls
                           << " mkm=" << ss.makeMain << " mkq=" << ss.makeQ << " pinc=" << ss.pinCalc << "\n";
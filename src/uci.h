@@ -94,6 +94,8 @@ static inline void uci_id(const Engine&) {
     std::cout << "option name SyzygyPath type string default <empty>\n";
     std::cout << "option name Skill Level type spin default 20 min 0 max 20\n";
     std::cout << "option name SearchStats type check default false\n";
+    std::cout << "option name Thread Affinity type check default false\n";
+    std::cout << "option name SMP Mode type combo default LazySMP var LazySMP var ABDADA var YBWC\n";
     std::cout << "option name UseBook type check default true\n";
     std::cout << "option name BookDepth type spin default 16 min 0 max 128\n";
     std::cout << "option name BookFile type string default GMopenings.bin\n";
@@ -191,6 +193,18 @@ static inline void cmd_setoption(const std::vector<std::string>& tokens, Engine&
         return;
     }
 
+    if (lname == "thread affinity") {
+        bool b = to_bool_safe(value, false);
+        engine.set_thread_affinity(b);
+        return;
+    }
+
+    if (lname == "smp mode") {
+        const std::string v = to_lower(value);
+        engine.set_smp_mode(v == "abdada" ? search::SMP_ABDADA : (v == "ybwc" ? search::SMP_YBWC : search::SMP_LAZY));
+        return;
+    }
+
     if (lname == "usebook") {
         bool b = to_bool_safe(value, true);
         engine.set_use_book(b);
@@ -309,19 +323,12 @@ static inline void cmd_go(const std::vector<std::string>& tokens, Engine& engine
     int bestMove =
         engine.go(depth_arg, movetime_arg, infinite, wtime_arg, btime_arg, winc_arg, binc_arg, mtg_arg, ponder);
 
-    // Ponder searches do not output bestmove until ponderhit.
+    // Ponder searches print bestmove from their own thread after ponderhit or stop.
     if (ponder) {
         return;
     }
 
-    int ponderMove = engine.get_last_ponder_move();
-
-    std::cout << "bestmove " << engine.move_to_uci(bestMove);
-    if (ponderMove) {
-        std::cout << " ponder " << engine.move_to_uci(ponderMove);
-    }
-    std::cout << "\n";
-    std::cout.flush();
+    engine.print_bestmove(bestMove, engine.get_last_ponder_move());
 }
 
 // Main UCI input loop.
@@ -352,7 +359,6 @@ static inline void loop(Engine& engine) {
             cmd_go(tokens, engine);
         } else if (cmd == "ponderhit") {
             engine.ponderhit();
-            // Many GUIs will send a fresh "go" after ponderhit.
         } else if (cmd == "stop") {
             engine.stop();
         } else if (cmd == "quit") {